@@ -0,0 +1,324 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+
+//==============================================================================
+// Counts of values in equal-width bins. One thread adds, any thread may read.
+// Values below the range land in the first bin and values above it in the
+// last, so nothing is dropped.
+template <int numBins>
+class Histogram
+{
+public:
+    static constexpr int size = numBins;
+
+    Histogram(double lowestValue, double widthOfBin) noexcept
+        : lowest(lowestValue), binWidth(widthOfBin) {}
+
+    void add(double value) noexcept
+    {
+        const auto bin = juce::jlimit(0, numBins - 1, (int) ((value - lowest) / binWidth));
+        counts[(size_t) bin].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void clear() noexcept
+    {
+        for (auto& count : counts)
+            count.store(0, std::memory_order_relaxed);
+    }
+
+    juce::uint32 getCount(int bin) const noexcept  { return counts[(size_t) bin].load(std::memory_order_relaxed); }
+    double getBinStart(int bin) const noexcept     { return lowest + bin * binWidth; }
+    double getBinEnd(int bin) const noexcept       { return lowest + (bin + 1) * binWidth; }
+
+    juce::uint64 getTotal() const noexcept
+    {
+        juce::uint64 total = 0;
+
+        for (const auto& count : counts)
+            total += count.load(std::memory_order_relaxed);
+
+        return total;
+    }
+
+    // Upper edge of the bin holding the given fraction (0-1) of the values
+    double getPercentile(double fraction) const noexcept
+    {
+        const auto total = getTotal();
+
+        if (total == 0)
+            return 0.0;
+
+        const auto target = (juce::uint64) std::ceil(fraction * (double) total);
+        juce::uint64 runningTotal = 0;
+
+        for (int bin = 0; bin < numBins; ++bin)
+        {
+            runningTotal += getCount(bin);
+
+            if (runningTotal >= target)
+                return getBinEnd(bin);
+        }
+
+        return getBinEnd(numBins - 1);
+    }
+
+private:
+    const double lowest;
+    const double binWidth;
+    std::array<std::atomic<juce::uint32>, (size_t) numBins> counts {};
+
+    JUCE_DECLARE_NON_COPYABLE(Histogram)
+};
+
+//==============================================================================
+// Times every audio callback against its deadline, the length of audio it
+// had to produce. Keeps histograms of callback duration, the share of the
+// deadline used and voices sounding, plus how far past its deadline each
+// block carrying a chord change finished, and counts of overruns and of gaps
+// between callbacks long enough to mean the device dropped out. The audio
+// thread only does relaxed atomic updates, so this stays on in release
+// builds; the UI reads it whenever it likes.
+class AudioCallbackMonitor
+{
+public:
+    struct Summary
+    {
+        juce::uint64 callbacks = 0;
+        double sampleRate = 0.0;
+        int blockSize = 0;
+        double budgetMs = 0.0;      // Length of audio in an expected block
+        double meanMs = 0.0;
+        double p99Ms = 0.0;
+        double maxMs = 0.0;
+        double meanLoad = 0.0;      // Share of the deadline used, 1 = all of it
+        double p99Load = 0.0;
+        double maxLoad = 0.0;
+        juce::uint32 overruns = 0;  // Callbacks that took longer than their deadline
+        juce::uint32 dropouts = 0;  // Gaps between callbacks that suggest an xrun
+        juce::uint32 chordEvents = 0;
+        juce::uint32 lateChordEvents = 0;
+        int peakVoices = 0;
+    };
+
+    AudioCallbackMonitor() = default;
+
+    // Call from prepareToPlay, before the callbacks start
+    void prepare(double newSampleRate, int newBlockSize) noexcept
+    {
+        sampleRate.store(newSampleRate);
+        blockSize.store(newBlockSize);
+        lastStartTicks = 0;
+        reset();
+    }
+
+    //==============================================================================
+    // Audio thread: call first thing in the callback and pass the result to endCallback()
+    static juce::int64 beginCallback() noexcept  { return juce::Time::getHighResolutionTicks(); }
+
+    void endCallback(juce::int64 startTicks, int numSamples, int activeVoices, int chordEventsInBlock) noexcept
+    {
+        const auto endTicks = juce::Time::getHighResolutionTicks();
+        const auto durationUs = juce::Time::highResolutionTicksToSeconds(endTicks - startTicks) * 1.0e6;
+        const auto rate = sampleRate.load(std::memory_order_relaxed);
+        const auto budgetUs = rate > 0.0 ? numSamples * 1.0e6 / rate : 0.0;
+        const auto load = budgetUs > 0.0 ? durationUs / budgetUs : 0.0;
+
+        // A callback that starts well after the previous block ran out means
+        // the device had nothing to play in between
+        if (lastStartTicks != 0
+            && juce::Time::highResolutionTicksToSeconds(startTicks - lastStartTicks) * 1.0e6 > lastBudgetUs * dropoutThreshold)
+            dropouts.fetch_add(1, std::memory_order_relaxed);
+
+        lastStartTicks = startTicks;
+        lastBudgetUs = budgetUs;
+
+        durations.add(durationUs);
+        loads.add(load * 100.0);
+        voices.add(activeVoices);
+
+        totalDurationUs.store(totalDurationUs.load(std::memory_order_relaxed) + durationUs, std::memory_order_relaxed);
+        totalLoad.store(totalLoad.load(std::memory_order_relaxed) + load, std::memory_order_relaxed);
+
+        if (durationUs > maxDurationUs.load(std::memory_order_relaxed))
+            maxDurationUs.store(durationUs, std::memory_order_relaxed);
+
+        if (load > maxLoad.load(std::memory_order_relaxed))
+            maxLoad.store(load, std::memory_order_relaxed);
+
+        // Chords from a block that missed its deadline reach the speakers late
+        const auto lateUs = juce::jmax(0.0, durationUs - budgetUs);
+
+        for (int i = 0; i < chordEventsInBlock; ++i)
+            chordLateness.add(lateUs);
+
+        chordEvents.fetch_add((juce::uint32) chordEventsInBlock, std::memory_order_relaxed);
+
+        if (lateUs > 0.0)
+        {
+            overruns.fetch_add(1, std::memory_order_relaxed);
+            lateChordEvents.fetch_add((juce::uint32) chordEventsInBlock, std::memory_order_relaxed);
+        }
+    }
+
+    //==============================================================================
+    // Any thread. Counts from a callback running at the same time may be lost.
+    void reset() noexcept
+    {
+        durations.clear();
+        loads.clear();
+        voices.clear();
+        chordLateness.clear();
+        totalDurationUs = 0.0;
+        totalLoad = 0.0;
+        maxDurationUs = 0.0;
+        maxLoad = 0.0;
+        overruns = 0;
+        dropouts = 0;
+        chordEvents = 0;
+        lateChordEvents = 0;
+    }
+
+    Summary getSummary() const noexcept
+    {
+        Summary summary;
+        summary.callbacks = durations.getTotal();
+        summary.sampleRate = sampleRate.load();
+        summary.blockSize = blockSize.load();
+        summary.budgetMs = summary.sampleRate > 0.0 ? summary.blockSize * 1000.0 / summary.sampleRate : 0.0;
+        summary.p99Ms = durations.getPercentile(0.99) / 1000.0;
+        summary.maxMs = maxDurationUs.load() / 1000.0;
+        summary.p99Load = loads.getPercentile(0.99) / 100.0;
+        summary.maxLoad = maxLoad.load();
+        summary.overruns = overruns.load();
+        summary.dropouts = dropouts.load();
+        summary.chordEvents = chordEvents.load();
+        summary.lateChordEvents = lateChordEvents.load();
+
+        if (summary.callbacks > 0)
+        {
+            summary.meanMs = totalDurationUs.load() / 1000.0 / (double) summary.callbacks;
+            summary.meanLoad = totalLoad.load() / (double) summary.callbacks;
+        }
+
+        for (int bin = voices.size - 1; bin >= 0; --bin)
+        {
+            if (voices.getCount(bin) > 0)
+            {
+                summary.peakVoices = bin;
+                break;
+            }
+        }
+
+        return summary;
+    }
+
+    //==============================================================================
+    // One row per histogram bin that has any values
+    juce::String toCsv() const
+    {
+        juce::String csv = "histogram,bin_start,bin_end,count\n";
+
+        forEachHistogram([&csv](const juce::String& name, auto& histogram) {
+            for (int bin = 0; bin < histogram.size; ++bin)
+                if (const auto count = histogram.getCount(bin))
+                    csv << name << ',' << histogram.getBinStart(bin) << ',' << histogram.getBinEnd(bin) << ',' << (int) count << '\n';
+        });
+
+        return csv;
+    }
+
+    // The summary plus the same histograms as toCsv()
+    juce::String toJson() const
+    {
+        const auto summary = getSummary();
+        auto* root = new juce::DynamicObject();
+        root->setProperty("callbacks", (juce::int64) summary.callbacks);
+        root->setProperty("sampleRate", summary.sampleRate);
+        root->setProperty("blockSize", summary.blockSize);
+        root->setProperty("budgetMs", summary.budgetMs);
+        root->setProperty("meanMs", summary.meanMs);
+        root->setProperty("p99Ms", summary.p99Ms);
+        root->setProperty("maxMs", summary.maxMs);
+        root->setProperty("meanLoad", summary.meanLoad);
+        root->setProperty("p99Load", summary.p99Load);
+        root->setProperty("maxLoad", summary.maxLoad);
+        root->setProperty("overruns", (int) summary.overruns);
+        root->setProperty("dropouts", (int) summary.dropouts);
+        root->setProperty("chordEvents", (int) summary.chordEvents);
+        root->setProperty("lateChordEvents", (int) summary.lateChordEvents);
+        root->setProperty("peakVoices", summary.peakVoices);
+
+        auto* histograms = new juce::DynamicObject();
+
+        forEachHistogram([histograms](const juce::String& name, auto& histogram) {
+            juce::Array<juce::var> bins;
+
+            for (int bin = 0; bin < histogram.size; ++bin)
+            {
+                if (const auto count = histogram.getCount(bin))
+                {
+                    auto* entry = new juce::DynamicObject();
+                    entry->setProperty("start", histogram.getBinStart(bin));
+                    entry->setProperty("end", histogram.getBinEnd(bin));
+                    entry->setProperty("count", (int) count);
+                    bins.add(juce::var(entry));
+                }
+            }
+
+            histograms->setProperty(name, bins);
+        });
+
+        root->setProperty("histograms", juce::var(histograms));
+        return juce::JSON::toString(juce::var(root));
+    }
+
+    // Writes CSV for a .csv file and JSON for anything else
+    juce::Result saveTo(const juce::File& file) const
+    {
+        const auto text = file.hasFileExtension("csv") ? toCsv() : toJson();
+
+        if (!file.replaceWithText(text))
+            return juce::Result::fail("Couldn't write " + file.getFullPathName());
+
+        return juce::Result::ok();
+    }
+
+private:
+    template <typename Callback>
+    void forEachHistogram(Callback&& callback) const
+    {
+        callback("durationUs", durations);
+        callback("loadPercent", loads);
+        callback("activeVoices", voices);
+        callback("chordLatenessUs", chordLateness);
+    }
+
+    static constexpr double dropoutThreshold = 1.5;  // Gap, in blocks, counted as a dropout
+
+    // Set in prepare()
+    std::atomic<double> sampleRate { 0.0 };
+    std::atomic<int> blockSize { 0 };
+
+    // Audio thread only
+    juce::int64 lastStartTicks = 0;
+    double lastBudgetUs = 0.0;
+
+    Histogram<200> durations { 0.0, 100.0 };      // 0-20 ms in 0.1 ms steps
+    Histogram<100> loads { 0.0, 2.0 };            // 0-200% in 2% steps
+    Histogram<65> voices { 0.0, 1.0 };            // 0-64 voices
+    Histogram<100> chordLateness { 0.0, 100.0 };  // 0-10 ms in 0.1 ms steps; the first bin is on time
+
+    std::atomic<double> totalDurationUs { 0.0 };
+    std::atomic<double> totalLoad { 0.0 };
+    std::atomic<double> maxDurationUs { 0.0 };
+    std::atomic<double> maxLoad { 0.0 };
+    std::atomic<juce::uint32> overruns { 0 };
+    std::atomic<juce::uint32> dropouts { 0 };
+    std::atomic<juce::uint32> chordEvents { 0 };
+    std::atomic<juce::uint32> lateChordEvents { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE(AudioCallbackMonitor)
+};
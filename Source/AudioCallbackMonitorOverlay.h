@@ -0,0 +1,131 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "AudioCallbackMonitor.h"
+#include "ChordSynthesiser.h"
+
+//==============================================================================
+// Small panel showing the audio callback's load, voices and dropouts, with
+// buttons to clear the figures and to save them as CSV or JSON. Polls the
+// monitor a few times a second while visible.
+class AudioCallbackMonitorOverlay : public juce::Component,
+                                    private juce::Timer
+{
+public:
+    AudioCallbackMonitorOverlay(AudioCallbackMonitor& monitorToShow, const ChordSynthesiser& synthToShow,
+                                juce::AudioDeviceManager& devices)
+        : monitor(monitorToShow), synth(synthToShow), deviceManager(devices)
+    {
+        resetButton.setButtonText("Reset");
+        resetButton.onClick = [this] {
+            monitor.reset();
+            xrunsAtReset = juce::jmax(0, getDeviceXRuns());
+            repaint();
+        };
+        addAndMakeVisible(resetButton);
+
+        saveButton.setButtonText("Save...");
+        saveButton.onClick = [this] { save(); };
+        addAndMakeVisible(saveButton);
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        g.setColour(juce::Colours::black.withAlpha(0.75f));
+        g.fillRoundedRectangle(getLocalBounds().toFloat(), 6.0f);
+
+        const auto summary = monitor.getSummary();
+        const auto voices = synth.getStatistics();
+        const auto xruns = getDeviceXRuns();
+
+        juce::StringArray lines;
+        lines.add("CPU " + percent(summary.meanLoad) + " avg, " + percent(summary.p99Load) + " p99, "
+                  + percent(summary.maxLoad) + " max");
+        lines.add("Callback " + juce::String(summary.meanMs, 2) + " ms avg, " + juce::String(summary.maxMs, 2)
+                  + " ms max of " + juce::String(summary.budgetMs, 2) + " ms ("
+                  + juce::String(summary.blockSize) + " @ " + juce::String(summary.sampleRate, 0) + " Hz)");
+        lines.add("Voices " + juce::String(voices.activeVoices) + " of " + juce::String(voices.polyphony)
+                  + ", peak " + juce::String(summary.peakVoices) + ", steals " + juce::String(voices.voiceSteals));
+        lines.add("Overruns " + juce::String((int) summary.overruns) + ", dropouts " + juce::String((int) summary.dropouts)
+                  + ", device xruns " + (xruns >= 0 ? juce::String(xruns - xrunsAtReset) : juce::String("n/a"))
+                  + ", late chords " + juce::String((int) summary.lateChordEvents) + "/" + juce::String((int) summary.chordEvents));
+
+        g.setColour(juce::Colours::white);
+        g.setFont(juce::FontOptions(juce::Font::getDefaultMonospacedFontName(), 12.0f, juce::Font::plain));
+
+        auto area = getLocalBounds().reduced(8, 6);
+        area.removeFromBottom(buttonHeight);
+
+        for (const auto& line : lines)
+            g.drawText(line, area.removeFromTop(16), juce::Justification::centredLeft, true);
+    }
+
+    void resized() override
+    {
+        auto buttons = getLocalBounds().reduced(8, 6).removeFromBottom(buttonHeight);
+        saveButton.setBounds(buttons.removeFromRight(70));
+        buttons.removeFromRight(6);
+        resetButton.setBounds(buttons.removeFromRight(70));
+    }
+
+    void visibilityChanged() override
+    {
+        if (isVisible())
+            startTimerHz(4);
+        else
+            stopTimer();
+    }
+
+private:
+    static constexpr int buttonHeight = 22;
+
+    void timerCallback() override  { repaint(); }
+
+    static juce::String percent(double load)
+    {
+        return juce::String(juce::roundToInt(load * 100.0)) + "%";
+    }
+
+    // -1 if the driver doesn't report xruns
+    int getDeviceXRuns() const
+    {
+        if (auto* device = deviceManager.getCurrentAudioDevice())
+            return device->getXRunCount();
+
+        return -1;
+    }
+
+    void save()
+    {
+        fileChooser = std::make_unique<juce::FileChooser>(
+            "Save audio statistics",
+            juce::File::getSpecialLocation(juce::File::userDocumentsDirectory).getChildFile("chord_builder_audio_stats.json"),
+            "*.json;*.csv");
+
+        auto flags = juce::FileBrowserComponent::saveMode
+                   | juce::FileBrowserComponent::canSelectFiles
+                   | juce::FileBrowserComponent::warnAboutOverwriting;
+
+        fileChooser->launchAsync(flags, [this](const juce::FileChooser& chooser) {
+            auto file = chooser.getResult();
+
+            if (file == juce::File())
+                return;
+
+            const auto result = monitor.saveTo(file.hasFileExtension("json;csv") ? file : file.withFileExtension("json"));
+
+            if (result.failed())
+                juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::WarningIcon,
+                                                       "Save failed", result.getErrorMessage());
+        });
+    }
+
+    AudioCallbackMonitor& monitor;
+    const ChordSynthesiser& synth;
+    juce::AudioDeviceManager& deviceManager;
+    juce::TextButton resetButton, saveButton;
+    std::unique_ptr<juce::FileChooser> fileChooser;
+    int xrunsAtReset = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioCallbackMonitorOverlay)
+};
@@ -0,0 +1,99 @@
+#include "AudioThreadGuard.h"
+
+#if CHORD_BUILDER_CHECK_AUDIO_ALLOCATIONS
+
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+
+#if JUCE_LINUX && defined(__GLIBC__)
+
+//==============================================================================
+// glibc lets an executable define the malloc family itself, and every
+// library in the process then calls these. Each forwards to glibc's own
+// allocator, so memory from either side can be freed by the other.
+// operator new, std::vector, juce::String and plain C code all end up here.
+extern "C"
+{
+    void* __libc_malloc(std::size_t);
+    void* __libc_calloc(std::size_t, std::size_t);
+    void* __libc_realloc(void*, std::size_t);
+    void* __libc_memalign(std::size_t, std::size_t);
+    void __libc_free(void*);
+
+    void* malloc(std::size_t size) noexcept
+    {
+        AudioThreadGuard::allocationMade();
+        return __libc_malloc(size);
+    }
+
+    void* calloc(std::size_t count, std::size_t size) noexcept
+    {
+        AudioThreadGuard::allocationMade();
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* memory, std::size_t size) noexcept
+    {
+        AudioThreadGuard::allocationMade();
+        return __libc_realloc(memory, size);
+    }
+
+    void* memalign(std::size_t alignment, std::size_t size) noexcept
+    {
+        AudioThreadGuard::allocationMade();
+        return __libc_memalign(alignment, size);
+    }
+
+    void* aligned_alloc(std::size_t alignment, std::size_t size) noexcept
+    {
+        return memalign(alignment, size);
+    }
+
+    int posix_memalign(void** result, std::size_t alignment, std::size_t size) noexcept
+    {
+        if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0)
+            return EINVAL;
+
+        if (auto* memory = memalign(alignment, size))
+        {
+            *result = memory;
+            return 0;
+        }
+
+        return ENOMEM;
+    }
+
+    void free(void* memory) noexcept
+    {
+        __libc_free(memory);
+    }
+}
+
+#else
+
+//==============================================================================
+// The array and nothrow forms go through these by default
+void* operator new(std::size_t size)
+{
+    AudioThreadGuard::allocationMade();
+
+    if (auto* memory = std::malloc(size > 0 ? size : 1))
+        return memory;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+#endif
+
+#endif
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Debug builds of the app hook the heap (see AudioThreadGuard.cpp) so an
+// allocation inside an audio callback trips an assertion. On Linux the whole
+// malloc family is hooked, which catches C code and system libraries too.
+// Elsewhere only the global operator new is replaced, so direct malloc,
+// calloc or realloc calls, and aligned operator new, go unnoticed there.
+// Plugins never hook anything: doing so in a plugin would also hook the host.
+#ifndef CHORD_BUILDER_CHECK_AUDIO_ALLOCATIONS
+ #define CHORD_BUILDER_CHECK_AUDIO_ALLOCATIONS JUCE_DEBUG
+#endif
+
+//==============================================================================
+// Marks the current thread as running an audio callback for the lifetime of
+// a Scope. Costs a thread_local write per callback, so it stays in release
+// builds too.
+class AudioThreadGuard
+{
+public:
+    class Scope
+    {
+    public:
+        Scope() noexcept : wasInCallback(inCallback)  { inCallback = true; }
+        ~Scope() noexcept                             { inCallback = wasInCallback; }
+
+    private:
+        const bool wasInCallback;
+
+        JUCE_DECLARE_NON_COPYABLE(Scope)
+    };
+
+    static bool isInCallback() noexcept  { return inCallback; }
+
+    // Called for every allocation when the check is compiled in
+    static void allocationMade() noexcept
+    {
+        if (!inCallback)
+            return;
+
+        // Logging the assertion allocates, so don't catch that one too
+        inCallback = false;
+        jassertfalse;  // Heap allocation on the audio thread
+        inCallback = true;
+    }
+
+private:
+    static inline thread_local bool inCallback = false;
+};
@@ -0,0 +1,436 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <iostream>
+#include "ProgressionExport.h"
+#include "VoiceLeader.h"
+#include "OfflineRenderer.h"
+
+//==============================================================================
+// Headless batch mode: writes a MIDI file (and optionally rendered audio) for
+// every combination of key, progression, emotion and voicing, spread across a
+// thread pool. Needs no display or audio device, so it can build preview and
+// training corpora on a build server.
+//
+//   ChordBuilder --headless [--manifest=batch.json] [--keys=C,G,A#|all]
+//                [--progressions=I-V-vi-IV,ii-V-I|all] [--emotions=none,Happy,Sad_Min9|all]
+//                [--voicings=Close,Drop2|all] [--sevenths] [--voice-leading] [--tempo=120]
+//                [--time-signature=4/4] [--audio=wav|flac] [--output=dir] [--threads=n]
+//
+// A manifest is a JSON object with the same settings ("keys", "progressions",
+// "emotions", "voicings", "sevenths", "voiceLeading", "tempo", "timeSignature",
+// "audio", "output", "threads"); lists may be arrays or comma separated strings.
+// Options given on the command line override the manifest.
+class BatchGenerator
+{
+public:
+    struct Options
+    {
+        juce::StringArray keys { "C" };
+        juce::StringArray progressions { "I-V-vi-IV" };
+        juce::StringArray emotions { "none" };
+        juce::StringArray voicings { "Close" };
+        bool useSevenths = false;
+        bool useVoiceLeading = false;  // Revoice each progression with VoiceLeader
+        double tempo = 120.0;
+        int beatsPerMeasure = 4;
+        int beatUnit = 4;
+        juce::String audioFormat;  // Empty for MIDI only, otherwise "wav" or "flac"
+        juce::File outputDirectory = juce::File::getCurrentWorkingDirectory().getChildFile("chord_builder_batch");
+        int numThreads = juce::SystemStats::getNumCpus();
+    };
+
+    // One file (or pair of files) to generate
+    struct Job
+    {
+        KeyManager::Key key = KeyManager::Key::C;
+        juce::String progressionName;
+        std::vector<int> degrees;
+        bool hasEmotion = false;
+        EmotionWheel::Emotion emotion = EmotionWheel::Emotion::Happy_Maj6;
+        KeyManager::Voicing voicing = KeyManager::Voicing::Close;
+        juce::String baseName;
+    };
+
+    static bool isHeadlessCommandLine(const juce::ArgumentList& args)
+    {
+        return args.containsOption("--headless");
+    }
+
+    // Runs a whole batch and returns the process exit code
+    static int run(const juce::ArgumentList& args)
+    {
+        if (args.containsOption("--help|-h"))
+        {
+            std::cout << "Usage: " << args.executableName << " --headless [options]\n"
+                      << "  --manifest=<file>          JSON file with the settings below\n"
+                      << "  --keys=<list|all>          e.g. C,F#,A# (default C)\n"
+                      << "  --progressions=<list|all>  roman numerals, e.g. I-V-vi-IV,ii-V-I\n"
+                      << "  --emotions=<list|all>      none, a category (Happy) or an emotion (Sad_Min9)\n"
+                      << "  --voicings=<list|all>      Close, Open, Drop2, Drop3, RootPosition,\n"
+                      << "                             FirstInversion, SecondInversion, Spread\n"
+                      << "  --sevenths                 use seventh chords where no emotion is applied\n"
+                      << "  --voice-leading            pick inversions for the smoothest voice leading\n"
+                      << "  --tempo=<bpm>              default 120\n"
+                      << "  --time-signature=<n/d>     default 4/4\n"
+                      << "  --audio=<wav|flac>         also render audio\n"
+                      << "  --output=<dir>             default ./chord_builder_batch\n"
+                      << "  --threads=<n>              default: number of CPUs" << std::endl;
+            return 0;
+        }
+
+        Options options;
+        std::vector<Job> jobs;
+        auto result = parseOptions(args, options);
+
+        if (result.wasOk())
+            result = createJobs(options, jobs);
+
+        if (result.wasOk() && !options.outputDirectory.createDirectory())
+            result = juce::Result::fail("Couldn't create " + options.outputDirectory.getFullPathName());
+
+        if (result.failed())
+        {
+            std::cerr << "Error: " << result.getErrorMessage() << std::endl;
+            return 1;
+        }
+
+        std::cout << "Generating " << jobs.size() << " progressions into "
+                  << options.outputDirectory.getFullPathName() << " on "
+                  << options.numThreads << " threads" << std::endl;
+
+        const auto startTime = juce::Time::getMillisecondCounterHiRes();
+        std::atomic<int> numFailed { 0 };
+
+        {
+            juce::ThreadPool pool(juce::ThreadPoolOptions{}.withThreadName("Batch generator")
+                                                           .withNumberOfThreads(options.numThreads));
+
+            for (const auto& job : jobs)
+            {
+                pool.addJob([&options, &numFailed, job] {
+                    auto jobResult = generate(job, options);
+
+                    if (jobResult.failed())
+                    {
+                        std::cerr << jobResult.getErrorMessage() + "\n";
+                        ++numFailed;
+                    }
+                });
+            }
+
+            while (pool.getNumJobs() > 0)
+                juce::Thread::sleep(20);
+        }
+
+        const auto seconds = (juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+        std::cout << "Finished " << (int) jobs.size() - numFailed << " of " << jobs.size()
+                  << " in " << juce::String(seconds, 2) << " s" << std::endl;
+
+        return numFailed == 0 ? 0 : 1;
+    }
+
+    static juce::Result parseOptions(const juce::ArgumentList& args, Options& options)
+    {
+        if (args.containsOption("--manifest"))
+        {
+            auto manifest = getFileForOption(args, "--manifest");
+
+            if (!manifest.existsAsFile())
+                return juce::Result::fail("Manifest not found: " + manifest.getFullPathName());
+
+            auto result = loadManifest(manifest, options);
+
+            if (result.failed())
+                return result;
+        }
+
+        if (args.containsOption("--keys"))           options.keys = splitList(args.getValueForOption("--keys"));
+        if (args.containsOption("--progressions"))   options.progressions = splitList(args.getValueForOption("--progressions"));
+        if (args.containsOption("--emotions"))       options.emotions = splitList(args.getValueForOption("--emotions"));
+        if (args.containsOption("--voicings"))       options.voicings = splitList(args.getValueForOption("--voicings"));
+        if (args.containsOption("--sevenths"))       options.useSevenths = true;
+        if (args.containsOption("--voice-leading"))  options.useVoiceLeading = true;
+        if (args.containsOption("--tempo"))          options.tempo = args.getValueForOption("--tempo").getDoubleValue();
+        if (args.containsOption("--audio"))          options.audioFormat = args.getValueForOption("--audio").toLowerCase();
+        if (args.containsOption("--output"))         options.outputDirectory = getFileForOption(args, "--output");
+        if (args.containsOption("--threads"))        options.numThreads = args.getValueForOption("--threads").getIntValue();
+
+        if (args.containsOption("--time-signature")
+            && !parseTimeSignature(args.getValueForOption("--time-signature"), options))
+            return juce::Result::fail("Invalid time signature: " + args.getValueForOption("--time-signature"));
+
+        return validate(options);
+    }
+
+    static juce::Result loadManifest(const juce::File& file, Options& options)
+    {
+        juce::var manifest;
+        auto parseResult = juce::JSON::parse(file.loadFileAsString(), manifest);
+
+        if (parseResult.failed() || !manifest.isObject())
+            return juce::Result::fail("Couldn't read manifest " + file.getFileName() + ": " + parseResult.getErrorMessage());
+
+        auto readList = [&manifest](const char* name, juce::StringArray& list)
+        {
+            auto value = manifest.getProperty(name, {});
+
+            if (auto* array = value.getArray())
+            {
+                list.clear();
+
+                for (const auto& item : *array)
+                    list.add(item.toString());
+            }
+            else if (value.isString())
+            {
+                list = splitList(value.toString());
+            }
+        };
+
+        readList("keys", options.keys);
+        readList("progressions", options.progressions);
+        readList("emotions", options.emotions);
+        readList("voicings", options.voicings);
+
+        options.useSevenths = manifest.getProperty("sevenths", options.useSevenths);
+        options.useVoiceLeading = manifest.getProperty("voiceLeading", options.useVoiceLeading);
+        options.tempo = manifest.getProperty("tempo", options.tempo);
+        options.audioFormat = manifest.getProperty("audio", options.audioFormat).toString().toLowerCase();
+        options.numThreads = manifest.getProperty("threads", options.numThreads);
+
+        if (manifest.hasProperty("output"))
+        {
+            // Relative paths are taken from the manifest's folder
+            options.outputDirectory = file.getParentDirectory().getChildFile(manifest.getProperty("output", {}).toString());
+        }
+
+        if (manifest.hasProperty("timeSignature")
+            && !parseTimeSignature(manifest.getProperty("timeSignature", {}).toString(), options))
+            return juce::Result::fail("Invalid time signature in " + file.getFileName());
+
+        return juce::Result::ok();
+    }
+
+    // Expands the option lists into every key/progression/emotion/voicing combination
+    static juce::Result createJobs(const Options& options, std::vector<Job>& jobs)
+    {
+        KeyManager keyManager;
+        EmotionWheel emotionWheel;
+
+        std::vector<KeyManager::Key> keys;
+        std::vector<std::pair<juce::String, std::vector<int>>> progressions;
+        std::vector<std::pair<bool, EmotionWheel::Emotion>> emotions;
+        std::vector<KeyManager::Voicing> voicings;
+
+        for (const auto& name : expandAll(options.keys, getKeyNames(keyManager)))
+        {
+            auto index = getKeyNames(keyManager).indexOf(name, true);
+
+            if (index < 0)
+                return juce::Result::fail("Unknown key: " + name);
+
+            keys.push_back(static_cast<KeyManager::Key>(index));
+        }
+
+        juce::StringArray availableProgressions;
+
+        for (const auto& name : keyManager.getAvailableProgressions())
+            availableProgressions.add(name);
+
+        for (const auto& name : expandAll(options.progressions, availableProgressions))
+        {
+            auto degrees = ProgressionExport::parseDegrees(name);
+
+            if (degrees.empty())
+                return juce::Result::fail("Invalid progression: " + name + " (use roman numerals, e.g. I-V-vi-IV)");
+
+            if ((int) degrees.size() > ProgressionSnapshot::maxChords)
+                return juce::Result::fail("Progression " + name + " has more than "
+                                          + juce::String(ProgressionSnapshot::maxChords) + " chords");
+
+            progressions.emplace_back(name, degrees);
+        }
+
+        for (const auto& token : options.emotions)
+        {
+            if (token.equalsIgnoreCase("none"))
+            {
+                emotions.emplace_back(false, EmotionWheel::Emotion::Happy_Maj6);
+                continue;
+            }
+
+            bool found = false;
+
+            for (auto emotion : emotionWheel.getAllEmotions())
+            {
+                auto name = getEmotionName(emotion);
+                auto category = name.upToFirstOccurrenceOf(" ", false, false);
+
+                // "all", a whole category ("Happy") or one emotion ("Happy_Maj6")
+                if (token.equalsIgnoreCase("all") || token.equalsIgnoreCase(category)
+                    || normaliseName(token) == normaliseName(name))
+                {
+                    emotions.emplace_back(true, emotion);
+                    found = true;
+                }
+            }
+
+            if (!found)
+                return juce::Result::fail("Unknown emotion: " + token);
+        }
+
+        for (const auto& name : expandAll(options.voicings, ProgressionExport::getVoicingNames()))
+        {
+            auto index = ProgressionExport::getVoicingNames().indexOf(name, true);
+
+            if (index < 0)
+                return juce::Result::fail("Unknown voicing: " + name);
+
+            voicings.push_back(static_cast<KeyManager::Voicing>(index));
+        }
+
+        for (auto key : keys)
+            for (const auto& progression : progressions)
+                for (const auto& emotion : emotions)
+                    for (auto voicing : voicings)
+                    {
+                        Job job;
+                        job.key = key;
+                        job.progressionName = progression.first;
+                        job.degrees = progression.second;
+                        job.hasEmotion = emotion.first;
+                        job.emotion = emotion.second;
+                        job.voicing = voicing;
+
+                        auto emotionName = job.hasEmotion ? normaliseName(getEmotionName(job.emotion))
+                                                          : juce::String("none");
+
+                        job.baseName = juce::File::createLegalFileName(getKeyNames(keyManager)[(int) key].replace("#", "sharp")
+                                                                        + "_" + job.progressionName
+                                                                        + "_" + emotionName
+                                                                        + "_" + ProgressionExport::getVoicingNames()[(int) voicing]);
+                        jobs.push_back(job);
+                    }
+
+        if (jobs.empty())
+            return juce::Result::fail("Nothing to generate");
+
+        return juce::Result::ok();
+    }
+
+    // Writes one job's files; safe to call from several threads at once
+    static juce::Result generate(const Job& job, const Options& options)
+    {
+        // Each job has its own managers, since KeyManager holds the current key
+        KeyManager keyManager;
+        EmotionWheel emotionWheel;
+        keyManager.setCurrentKey(job.key);
+
+        std::vector<EmotionWheel::Emotion> emotions;
+
+        if (job.hasEmotion)
+            emotions.assign(job.degrees.size(), job.emotion);
+
+        auto progression = ProgressionExport::buildProgression(keyManager, emotionWheel, job.degrees, emotions,
+                                                               options.useSevenths, job.voicing);
+
+        if (options.useVoiceLeading)
+            progression = VoiceLeader::optimise(progression);
+
+        auto midiFile = ProgressionExport::createMidiFile(progression, options.tempo,
+                                                          options.beatsPerMeasure, options.beatUnit);
+        auto midiPath = options.outputDirectory.getChildFile(job.baseName + ".mid");
+
+        if (!ProgressionExport::writeMidiFile(midiFile, midiPath))
+            return juce::Result::fail("Couldn't write " + midiPath.getFullPathName());
+
+        if (options.audioFormat.isNotEmpty())
+        {
+            OfflineRenderer::Settings settings;
+            settings.tempo = options.tempo;
+            settings.beatsPerMeasure = options.beatsPerMeasure;
+            settings.beatUnit = options.beatUnit;
+
+            return OfflineRenderer::renderToFile(progression, settings,
+                                                 options.outputDirectory.getChildFile(job.baseName + "." + options.audioFormat));
+        }
+
+        return juce::Result::ok();
+    }
+
+private:
+    static juce::Result validate(Options& options)
+    {
+        if (options.tempo < 20.0 || options.tempo > 400.0)
+            return juce::Result::fail("Tempo must be between 20 and 400 BPM");
+
+        if (options.audioFormat.isNotEmpty() && options.audioFormat != "wav" && options.audioFormat != "flac")
+            return juce::Result::fail("Audio format must be wav or flac");
+
+        options.numThreads = juce::jlimit(1, 256, options.numThreads);
+        return juce::Result::ok();
+    }
+
+    // Like ArgumentList::getFileForOption, but without throwing on a missing value
+    static juce::File getFileForOption(const juce::ArgumentList& args, juce::StringRef option)
+    {
+        return juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption(option).unquoted());
+    }
+
+    static bool parseTimeSignature(const juce::String& text, Options& options)
+    {
+        auto beats = text.upToFirstOccurrenceOf("/", false, false).getIntValue();
+        auto unit = text.fromFirstOccurrenceOf("/", false, false).getIntValue();
+
+        if (beats < 1 || beats > 32 || !juce::isPowerOfTwo(unit) || unit > 32)
+            return false;
+
+        options.beatsPerMeasure = beats;
+        options.beatUnit = unit;
+        return true;
+    }
+
+    static juce::StringArray splitList(const juce::String& text)
+    {
+        auto list = juce::StringArray::fromTokens(text, ",", "\"");
+        list.trim();
+        list.removeEmptyStrings();
+        return list;
+    }
+
+    // Replaces "all" in a list with every available name
+    static juce::StringArray expandAll(const juce::StringArray& list, const juce::StringArray& available)
+    {
+        return list.contains("all", true) ? available : list;
+    }
+
+    // Lower-case letters and digits only, so "Sad_Min9", "sad min9" and
+    // "Sad (Min9)" all match. Flats can be typed as 'b'; sharps are spelled
+    // out like the key names, so "Tense (7#9)" is "tense7sharp9" and stays
+    // intact in file names.
+    static juce::String normaliseName(const juce::String& name)
+    {
+        return name.replace(juce::CharPointer_UTF8("\xe2\x99\xad"), "b")        // Flat sign
+                   .replace(juce::CharPointer_UTF8("\xe2\x99\xaf"), "sharp")    // Sharp sign
+                   .replace("#", "sharp")
+                   .toLowerCase()
+                   .retainCharacters("abcdefghijklmnopqrstuvwxyz0123456789");
+    }
+
+    static juce::String getEmotionName(EmotionWheel::Emotion emotion)
+    {
+        auto name = EmotionWheel::getEmotionName(emotion);
+        return juce::String::fromUTF8(name.data(), (int) name.size());
+    }
+
+    static juce::StringArray getKeyNames(const KeyManager& keyManager)
+    {
+        juce::StringArray names;
+
+        for (int i = 0; i < 12; ++i)
+            names.add(keyManager.getKeyName(static_cast<KeyManager::Key>(i)));
+
+        return names;
+    }
+};
@@ -0,0 +1,290 @@
+/*
+  ==============================================================================
+
+    Micro-benchmarks for the chord generation and synth hot paths, built as a
+    separate console app by Benchmarks/ChordBuilderBenchmarks.jucer.
+
+      ChordBuilderBenchmarks [--filter=<text>] [--min-time=<seconds>] [--output=<file>]
+
+    Prints a table to stderr and the results as JSON to stdout (or to the
+    --output file), so runs from two builds can be diffed or compared by a
+    script. Build the Release configuration; Debug timings mean little.
+
+    With --golden-check or --golden-update it instead runs the golden render
+    regression check in GoldenRenderCheck.h against Benchmarks/golden_renders.json.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <iostream>
+#include "KeyManager.h"
+#include "EmotionWheel.h"
+#include "ProgressionExport.h"
+#include "ChordSynthesiser.h"
+#include "GoldenRenderCheck.h"
+
+namespace
+{
+    //==============================================================================
+    // Times a piece of work in batches big enough for the clock to resolve, and
+    // reports the median and fastest time per operation over the batches
+    class BenchmarkRunner
+    {
+    public:
+        BenchmarkRunner(const juce::String& nameFilter, double minimumSeconds)
+            : filter(nameFilter), minSeconds(minimumSeconds) {}
+
+        // operation() is called once per iteration and returns a value the
+        // compiler can't prove unused. Extra fields in params are written
+        // alongside the timings; blockSeconds, if set, adds the share of a
+        // real-time block each operation takes.
+        template <typename Operation>
+        void run(const juce::String& name, const juce::NamedValueSet& params, Operation&& operation,
+                 double blockSeconds = 0.0)
+        {
+            if (filter.isNotEmpty() && !name.containsIgnoreCase(filter))
+                return;
+
+            // Grow the batch until it takes long enough to time reliably
+            juce::int64 batchSize = 1;
+
+            while (timeBatch(operation, batchSize) < minBatchSeconds && batchSize < (1 << 30))
+                batchSize *= 2;
+
+            std::vector<double> samples;
+            const auto start = juce::Time::getMillisecondCounterHiRes();
+
+            while (samples.size() < minSamples || juce::Time::getMillisecondCounterHiRes() - start < minSeconds * 1000.0)
+                samples.push_back(timeBatch(operation, batchSize) * 1.0e9 / (double) batchSize);
+
+            std::sort(samples.begin(), samples.end());
+
+            auto* result = new juce::DynamicObject();
+            result->setProperty("name", name);
+
+            for (const auto& param : params)
+                result->setProperty(param.name, param.value);
+
+            const auto medianNs = samples[samples.size() / 2];
+            result->setProperty("iterations", (juce::int64) samples.size() * batchSize);
+            result->setProperty("nsPerOp", medianNs);
+            result->setProperty("minNsPerOp", samples.front());
+
+            if (blockSeconds > 0.0)
+                result->setProperty("realtimeLoad", medianNs * 1.0e-9 / blockSeconds);
+
+            results.add(juce::var(result));
+
+            juce::String description;
+
+            for (const auto& param : params)
+                description << ' ' << param.name.toString() << '=' << param.value.toString();
+
+            std::cerr << (name + description).paddedRight(' ', 72) << juce::String(medianNs, 1).paddedLeft(' ', 12) << " ns/op"
+                      << (blockSeconds > 0.0 ? "   " + juce::String(medianNs * 1.0e-7 / blockSeconds, 2) + "% of real time" : juce::String())
+                      << std::endl;
+        }
+
+        juce::String toJson() const
+        {
+            auto* build = new juce::DynamicObject();
+            build->setProperty("juceVersion", juce::SystemStats::getJUCEVersion());
+           #if JUCE_DEBUG
+            build->setProperty("debug", true);
+           #else
+            build->setProperty("debug", false);
+           #endif
+            build->setProperty("compiled", juce::String(__DATE__) + " " + __TIME__);
+            build->setProperty("cpu", juce::SystemStats::getCpuModel());
+            build->setProperty("cores", juce::SystemStats::getNumPhysicalCpus());
+            build->setProperty("os", juce::SystemStats::getOperatingSystemName());
+
+            auto* root = new juce::DynamicObject();
+            root->setProperty("build", juce::var(build));
+            root->setProperty("date", juce::Time::getCurrentTime().toISO8601(true));
+            root->setProperty("benchmarks", results);
+            return juce::JSON::toString(juce::var(root));
+        }
+
+    private:
+        static constexpr double minBatchSeconds = 0.002;
+        static constexpr size_t minSamples = 7;
+
+        template <typename Operation>
+        double timeBatch(Operation& operation, juce::int64 batchSize)
+        {
+            const auto start = juce::Time::getHighResolutionTicks();
+
+            for (juce::int64 i = 0; i < batchSize; ++i)
+                sink += (int) operation();
+
+            return juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+        }
+
+        const juce::String filter;
+        const double minSeconds;
+        juce::Array<juce::var> results;
+        volatile int sink = 0;  // Keeps the timed work from being optimised away
+    };
+
+    //==============================================================================
+    void benchmarkChords(BenchmarkRunner& runner)
+    {
+        KeyManager keyManager;
+        int degree = 0;
+
+        // Cycle through all seven degrees so no one chord is favoured
+        auto nextDegree = [&degree] { return static_cast<KeyManager::ScaleDegree>(degree++ % 7 + 1); };
+
+        runner.run("KeyManager::generateTriad", {}, [&] { return keyManager.generateTriad(nextDegree()).size(); });
+        runner.run("KeyManager::generateSeventh", {}, [&] { return keyManager.generateSeventh(nextDegree()).size(); });
+
+        const auto seventh = keyManager.generateSeventh(KeyManager::ScaleDegree::II);
+
+        for (int voicing = 0; voicing < ProgressionExport::getVoicingNames().size(); ++voicing)
+        {
+            juce::NamedValueSet params;
+            params.set("voicing", ProgressionExport::getVoicingNames()[voicing]);
+
+            runner.run("KeyManager::applyVoicing", params, [&] {
+                return keyManager.applyVoicing(seventh, static_cast<KeyManager::Voicing>(voicing)).size();
+            });
+        }
+    }
+
+    void benchmarkEmotions(BenchmarkRunner& runner)
+    {
+        EmotionWheel emotionWheel;
+        const auto emotions = emotionWheel.getAllEmotions();
+        size_t index = 0;
+
+        runner.run("EmotionWheel::applyEmotion", {}, [&] {
+            const auto i = index++;
+            return emotionWheel.applyEmotion(60 + (int) (i % 12), emotions[i % emotions.size()]).size();
+        });
+    }
+
+    void benchmarkProgressions(BenchmarkRunner& runner)
+    {
+        KeyManager keyManager;
+        EmotionWheel emotionWheel;
+        const std::vector<int> degrees { 1, 5, 6, 4, 2, 5, 1, 1 };
+        const std::vector<EmotionWheel::Emotion> emotions { EmotionWheel::Emotion::Warm_Maj9, EmotionWheel::Emotion::Tense_7b9,
+                                                            EmotionWheel::Emotion::Sad_Min9, EmotionWheel::Emotion::Calm_Sus2 };
+
+        for (const bool withEmotions : { false, true })
+        {
+            juce::NamedValueSet params;
+            params.set("chords", (int) degrees.size());
+            params.set("emotions", withEmotions);
+
+            runner.run("ProgressionExport::buildProgression", params, [&] {
+                return ProgressionExport::buildProgression(keyManager, emotionWheel, degrees,
+                                                           withEmotions ? emotions : std::vector<EmotionWheel::Emotion>(),
+                                                           true, KeyManager::Voicing::Drop2).size();
+            });
+        }
+
+        runner.run("KeyManager::getCommonProgression", {}, [&] {
+            return keyManager.getCommonProgression("I-V-vi-IV", true, KeyManager::Voicing::Open).size();
+        });
+
+        const auto progression = ProgressionExport::buildProgression(keyManager, emotionWheel, degrees, emotions,
+                                                                     true, KeyManager::Voicing::Close);
+
+        runner.run("ProgressionExport::createMidiFile", {}, [&] {
+            return ProgressionExport::createMidiFile(progression, 120.0, 4, 4).getNumTracks();
+        });
+
+        runner.run("MidiFile::writeTo", {}, [&] {
+            juce::MemoryOutputStream stream;
+            ProgressionExport::createMidiFile(progression, 120.0, 4, 4).writeTo(stream);
+            return stream.getDataSize();
+        });
+    }
+
+    // Renders held notes through the same voice pool the app plays with
+    void benchmarkVoices(BenchmarkRunner& runner)
+    {
+        constexpr double sampleRate = 48000.0;
+
+        for (const int numVoices : { 1, 4, 8, 16, 32, 64 })
+        {
+            for (const int blockSize : { 64, 128, 256, 512, 1024 })
+            {
+                ChordSynthesiser synth;
+                synth.prepare(sampleRate, blockSize);
+                synth.setPolyphony(ChordSynthesiser::maxPolyphony);
+
+                juce::AudioBuffer<float> buffer(2, blockSize);
+                juce::MidiBuffer notes, noMidi;
+
+                for (int i = 0; i < numVoices; ++i)
+                    notes.addEvent(juce::MidiMessage::noteOn(1, 36 + i, 0.7f), 0);
+
+                synth.renderNextBlock(buffer, notes, 0, blockSize);
+                jassert(synth.getStatistics().activeVoices == numVoices);
+
+                juce::NamedValueSet params;
+                params.set("voices", numVoices);
+                params.set("blockSize", blockSize);
+                params.set("sampleRate", sampleRate);
+
+                runner.run("SineWaveVoice::renderNextBlock", params, [&] {
+                    synth.renderNextBlock(buffer, noMidi, 0, blockSize);
+                    return buffer.getSample(0, 0) > 0.0f;
+                }, blockSize / sampleRate);
+            }
+        }
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h"))
+    {
+        std::cout << "Usage: " << args.executableName << " [--filter=<text>] [--min-time=<seconds>] [--output=<file>]\n"
+                  << "       " << args.executableName << " --golden-check=<file> [--golden-filter=<text>] [--tolerance=<relative>]\n"
+                  << "       " << juce::String().paddedRight(' ', args.executableName.length()) << " [--max-render-ms=<per second of audio>]\n"
+                  << "       " << args.executableName << " --golden-update=<file>\n";
+        return 0;
+    }
+
+    if (GoldenRenderCheck::isGoldenCommandLine(args))
+        return GoldenRenderCheck::run(GoldenRenderCheck::parseOptions(args));
+
+    const auto minSeconds = args.containsOption("--min-time") ? args.getValueForOption("--min-time").getDoubleValue() : 0.2;
+    BenchmarkRunner runner(args.getValueForOption("--filter"), juce::jmax(0.01, minSeconds));
+
+   #if JUCE_DEBUG
+    std::cerr << "Warning: this is a Debug build\n";
+   #endif
+
+    benchmarkChords(runner);
+    benchmarkEmotions(runner);
+    benchmarkProgressions(runner);
+    benchmarkVoices(runner);
+
+    const auto json = runner.toJson();
+
+    if (args.containsOption("--output"))
+    {
+        const auto file = args.getFileForOption("--output");
+
+        if (!file.replaceWithText(json))
+        {
+            std::cerr << "Couldn't write " << file.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+    else
+    {
+        std::cout << json << std::endl;
+    }
+
+    return 0;
+}
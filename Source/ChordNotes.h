@@ -0,0 +1,55 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+#include "PitchClassSet.h"
+
+//==============================================================================
+// Fixed-capacity chord storage.
+// Holds MIDI note numbers inline so chords can be copied around the audio
+// thread without touching the heap.
+struct ChordNotes
+{
+    static constexpr int maxNotes = 8;
+
+    ChordNotes() = default;
+
+    ChordNotes(const std::vector<int>& chord)
+    {
+        for (int note : chord)
+            add(note);
+    }
+
+    // Adds a note if it is a valid MIDI note and there is room left
+    bool add(int note) noexcept
+    {
+        if (note < 0 || note > 127 || numNotes >= maxNotes)
+            return false;
+
+        notes[(size_t) numNotes++] = (juce::uint8) note;
+        return true;
+    }
+
+    void clear() noexcept                      { numNotes = 0; }
+    int size() const noexcept                  { return numNotes; }
+    bool isEmpty() const noexcept              { return numNotes == 0; }
+    int operator[](int index) const noexcept   { return notes[(size_t) index]; }
+
+    const juce::uint8* begin() const noexcept  { return notes.data(); }
+    const juce::uint8* end() const noexcept    { return notes.data() + numNotes; }
+
+    PitchClassSet getPitchClasses() const noexcept
+    {
+        return PitchClassSet::fromNotes(*this);
+    }
+
+    std::vector<int> toVector() const
+    {
+        return std::vector<int>(begin(), end());
+    }
+
+private:
+    std::array<juce::uint8, maxNotes> notes {};
+    int numNotes = 0;
+};
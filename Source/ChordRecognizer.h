@@ -0,0 +1,145 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <algorithm>
+#include <limits>
+#include "ChordTable.h"
+#include "EmotionWheel.h"
+
+//==============================================================================
+// Names any set of notes: the reverse of KeyManager::getChordName.
+// Every one of the 4096 pitch-class sets is matched once, on first use,
+// against each ChordType (from KeyManager::getChordIntervals) and each
+// EmotionWheel profile on every root. Recognising a chord is then one table
+// load, plus a rotation when the bass note is known. Sets that match no
+// template exactly get the nearest one, counted in pitch classes added or
+// missing. Lookups don't allocate and are safe from any thread.
+class ChordRecognizer
+{
+public:
+    static constexpr int numSets = 1 << PitchClassSet::numPitchClasses;
+
+    struct Match
+    {
+        int root = -1;  // Pitch class 0-11, or -1 for no notes
+        KeyManager::ChordType type = KeyManager::ChordType::Major;
+        int typeDistance = 0;  // Pitch classes that differ from the chord type
+        EmotionWheel::Emotion emotion = EmotionWheel::Emotion::Happy_Maj6;
+        int emotionDistance = 0;  // Pitch classes that differ from the emotion's chord
+
+        bool isValid() const noexcept  { return root >= 0; }
+        bool isExact() const noexcept  { return isValid() && typeDistance == 0; }
+    };
+
+    ChordRecognizer()
+    {
+        KeyManager keyManager;
+        std::array<PitchClassSet, ChordTable::numChordTypes> typeTemplates;
+
+        for (int type = 0; type < ChordTable::numChordTypes; ++type)
+            typeTemplates[(size_t) type] = keyManager.getChordPitchClasses(static_cast<KeyManager::ChordType>(type));
+
+        // Best match for each set with its root on C. Earlier (simpler)
+        // chord types and emotions win ties.
+        for (int bits = 1; bits < numSets; ++bits)
+        {
+            const auto set = PitchClassSet::fromBits((unsigned int) bits);
+            auto& match = rooted[(size_t) bits];
+            match.root = 0;
+            match.typeDistance = match.emotionDistance = PitchClassSet::numPitchClasses + 1;
+
+            for (int type = 0; type < ChordTable::numChordTypes; ++type)
+            {
+                auto distance = set.distanceTo(typeTemplates[(size_t) type]);
+
+                if (distance < match.typeDistance)
+                {
+                    match.typeDistance = distance;
+                    match.type = static_cast<KeyManager::ChordType>(type);
+                }
+            }
+
+            for (int emotion = 0; emotion < EmotionWheel::numEmotions; ++emotion)
+            {
+                auto distance = set.distanceTo(EmotionWheel::getPitchClasses(static_cast<EmotionWheel::Emotion>(emotion)));
+
+                if (distance < match.emotionDistance)
+                {
+                    match.emotionDistance = distance;
+                    match.emotion = static_cast<EmotionWheel::Emotion>(emotion);
+                }
+            }
+        }
+
+        // Best match over every root: rotate so the candidate root is on C and
+        // reuse the rooted result. Roots that are actually sounding win ties.
+        for (int bits = 1; bits < numSets; ++bits)
+        {
+            const auto set = PitchClassSet::fromBits((unsigned int) bits);
+            auto& match = best[(size_t) bits];
+            int bestScore = std::numeric_limits<int>::max();
+
+            for (int root = 0; root < PitchClassSet::numPitchClasses; ++root)
+            {
+                const auto& candidate = rooted[set.transposed(-root).getBits()];
+                auto score = (candidate.typeDistance * 2 + (set.contains(root) ? 0 : 1)) * 16 + candidate.emotionDistance;
+
+                if (score < bestScore)
+                {
+                    bestScore = score;
+                    match = candidate;
+                    match.root = root;
+                }
+            }
+        }
+    }
+
+    // Best match for a set of pitch classes, whatever the voicing
+    const Match& recognise(PitchClassSet pitchClasses) const noexcept
+    {
+        return best[pitchClasses.getBits()];
+    }
+
+    // As above, but when the lowest note is the root of an exact match it is
+    // preferred, so e.g. G-C-D reads as Gsus4 rather than Csus2
+    Match recognise(const ChordNotes& notes) const noexcept
+    {
+        if (notes.isEmpty())
+            return {};
+
+        return recognise(notes.getPitchClasses(), *std::min_element(notes.begin(), notes.end()));
+    }
+
+    // The same, given the pitch classes and the lowest note separately
+    Match recognise(PitchClassSet pitchClasses, int bassNote) const noexcept
+    {
+        if (pitchClasses.isEmpty() || bassNote < 0)
+            return recognise(pitchClasses);
+
+        const int bass = bassNote % PitchClassSet::numPitchClasses;
+        const auto& bassRooted = rooted[pitchClasses.transposed(-bass).getBits()];
+
+        if (bassRooted.typeDistance == 0)
+        {
+            auto match = bassRooted;
+            match.root = bass;
+            return match;
+        }
+
+        return recognise(pitchClasses);
+    }
+
+    // Built on first use, which takes a few milliseconds
+    static const ChordRecognizer& getInstance()
+    {
+        static const ChordRecognizer recognizer;
+        return recognizer;
+    }
+
+private:
+    std::array<Match, numSets> rooted;  // Indexed by the set transposed so its root is C
+    std::array<Match, numSets> best;    // Indexed by the set as played
+
+    JUCE_DECLARE_NON_COPYABLE(ChordRecognizer)
+};
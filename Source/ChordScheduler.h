@@ -0,0 +1,176 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <limits>
+#include "PlaybackCommands.h"
+
+//==============================================================================
+// Turns a progression into timestamped MIDI for the audio callback.
+// Each block it jumps straight to the next chord boundary instead of counting
+// samples, and writes note-on/off events at their exact offset in the block,
+// so chord timing is independent of the device buffer size. When an external
+// clock is in charge, playBar() is called on its bar lines instead.
+// All methods are meant to be called from the audio thread.
+class ChordScheduler
+{
+public:
+    ChordScheduler() = default;
+
+    void setMidiChannel(int channel) noexcept       { midiChannel = channel; }
+    void setVelocity(float newVelocity) noexcept    { velocity = newVelocity; }
+    void setLooping(bool shouldLoop) noexcept       { looping = shouldLoop; }
+
+    // Length of each chord in samples; takes effect from the next chord
+    void setChordLengthSamples(int numSamples) noexcept
+    {
+        chordLengthSamples = juce::jmax(1, numSamples);
+    }
+
+    // One measure per chord at the given tempo and time signature
+    static int getChordLengthSamples(double tempo, int beatsPerMeasure, int beatUnit, double sampleRate) noexcept
+    {
+        // The tempo counts quarter notes, so scale for other beat units
+        const double secondsPerBeat = (60.0 / tempo) * (4.0 / beatUnit);
+        return juce::jmax(1, (int) (secondsPerBeat * beatsPerMeasure * sampleRate));
+    }
+
+    bool isActive() const noexcept                  { return active; }
+    int getCurrentChordIndex() const noexcept       { return currentChordIndex; }
+    int getSamplesUntilNextChord() const noexcept   { return samplesUntilNextChord; }
+    juce::uint32 getNumChordsStarted() const noexcept  { return chordsStarted; }  // Running count, for instrumentation
+
+    // Starts the progression from its first chord at the beginning of the next block
+    void play(const ProgressionSnapshot& newProgression) noexcept
+    {
+        progression = newProgression;
+        currentChordIndex = 0;
+        samplesUntilNextChord = 0;
+        currentBar = noBar;
+        active = !progression.isEmpty();
+    }
+
+    // Swaps in new chords but keeps the current position. Notes that are
+    // already sounding carry on until the next chord boundary.
+    void update(const ProgressionSnapshot& newProgression) noexcept
+    {
+        if (active)
+            progression = newProgression;
+    }
+
+    // Stops playback, releasing any sounding notes at the given offset
+    void stop(juce::MidiBuffer& midi, int sampleOffset)
+    {
+        releaseSoundingChord(midi, sampleOffset);
+        active = false;
+        currentChordIndex = 0;
+        samplesUntilNextChord = 0;
+        currentBar = noBar;
+    }
+
+    // External clock: sounds the chord for a bar of the clock's song, from
+    // the given offset. The progression repeats every progression.size()
+    // bars for as long as the clock runs, and a bar already sounding is left
+    // alone, so this can be called at the start of every block.
+    void playBar(juce::MidiBuffer& midi, juce::int64 bar, int sampleOffset)
+    {
+        if (!active || bar == currentBar)
+            return;
+
+        releaseSoundingChord(midi, sampleOffset);
+        currentBar = bar;
+
+        const auto numChords = (juce::int64) progression.size();
+        currentChordIndex = (int) (((bar % numChords) + numChords) % numChords);
+        soundingChord = progression[currentChordIndex];
+        ++chordsStarted;
+
+        for (int note : soundingChord)
+            midi.addEvent(juce::MidiMessage::noteOn(midiChannel, note, velocity), sampleOffset);
+    }
+
+    // External clock stopped: silence the chord but stay ready for it to restart
+    void pause(juce::MidiBuffer& midi, int sampleOffset)
+    {
+        releaseSoundingChord(midi, sampleOffset);
+        currentBar = noBar;
+    }
+
+    // Adds this block's chord changes to the buffer.
+    // Returns true if the progression reached its end (without looping) during the block.
+    bool renderNextBlock(juce::MidiBuffer& midi, int numSamples)
+    {
+        int position = 0;
+
+        while (active)
+        {
+            const int samplesLeftInBlock = numSamples - position;
+
+            if (samplesUntilNextChord >= samplesLeftInBlock)
+            {
+                samplesUntilNextChord -= samplesLeftInBlock;
+                return false;
+            }
+
+            position += samplesUntilNextChord;
+            samplesUntilNextChord = 0;
+
+            if (!advanceToNextChord(midi, position))
+                return true;
+        }
+
+        return false;
+    }
+
+private:
+    // Handles a chord boundary; returns false if playback ended here
+    bool advanceToNextChord(juce::MidiBuffer& midi, int sampleOffset)
+    {
+        releaseSoundingChord(midi, sampleOffset);
+
+        if (currentChordIndex >= progression.size())
+        {
+            if (!looping || progression.isEmpty())
+            {
+                active = false;
+                currentChordIndex = 0;
+                return false;
+            }
+
+            // Loop back to the beginning
+            currentChordIndex = 0;
+        }
+
+        soundingChord = progression[currentChordIndex++];
+        ++chordsStarted;
+
+        for (int note : soundingChord)
+            midi.addEvent(juce::MidiMessage::noteOn(midiChannel, note, velocity), sampleOffset);
+
+        samplesUntilNextChord = chordLengthSamples;
+        return true;
+    }
+
+    void releaseSoundingChord(juce::MidiBuffer& midi, int sampleOffset)
+    {
+        for (int note : soundingChord)
+            midi.addEvent(juce::MidiMessage::noteOff(midiChannel, note), sampleOffset);
+
+        soundingChord.clear();
+    }
+
+    static constexpr juce::int64 noBar = std::numeric_limits<juce::int64>::min();
+
+    ProgressionSnapshot progression;
+    ChordNotes soundingChord;
+    juce::int64 currentBar = noBar;  // Bar sounding under an external clock
+    bool active = false;
+    bool looping = false;
+    int currentChordIndex = 0;
+    int samplesUntilNextChord = 0;
+    int chordLengthSamples = 1;
+    juce::uint32 chordsStarted = 0;
+    int midiChannel = 1;
+    float velocity = 0.7f;
+
+    JUCE_DECLARE_NON_COPYABLE(ChordScheduler)
+};
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "SineWaveVoice.h"
+#include "Tracing.h"
+
+//==============================================================================
+// Synthesiser with a preallocated pool of SineWaveVoices.
+// All maxPolyphony voices are created up front; setPolyphony() only changes
+// how many of them may be handed out, so it never allocates on the audio
+// thread. When the pool is exhausted the oldest released voice is stolen
+// first, then the oldest held one. Live counters let the UI size polyphony
+// against the CPU headroom actually available.
+class ChordSynthesiser : public juce::Synthesiser
+{
+public:
+    static constexpr int maxPolyphony = 64;
+    static constexpr int defaultPolyphony = 16;
+
+    struct Statistics
+    {
+        int polyphony = 0;     // Voices currently allowed
+        int activeVoices = 0;  // Voices sounding after the last render
+        int peakVoices = 0;    // Most voices sounding at once since the last reset
+        int voiceSteals = 0;   // Notes that had to take over a sounding voice
+    };
+
+    ChordSynthesiser()
+    {
+        for (int i = 0; i < maxPolyphony; ++i)
+            addVoice(new SineWaveVoice());
+
+        // Add a simple sine wave sound for all notes
+        addSound(new SineWaveSound());
+    }
+
+    // Call from prepareToPlay
+    void prepare(double sampleRate, int maximumBlockSize)
+    {
+        setCurrentPlaybackSampleRate(sampleRate);
+
+        for (auto* voice : voices)
+            if (auto* sineVoice = dynamic_cast<SineWaveVoice*>(voice))
+                sineVoice->prepare(maximumBlockSize);
+    }
+
+    void setPolyphony(int numVoices) noexcept
+    {
+        polyphony = juce::jlimit(1, maxPolyphony, numVoices);
+    }
+
+    int getPolyphony() const noexcept { return polyphony; }
+
+    void setWaveform(WaveformType type)
+    {
+        const juce::ScopedLock sl(lock);
+
+        for (auto* voice : voices)
+            if (auto* sineVoice = dynamic_cast<SineWaveVoice*>(voice))
+                sineVoice->setWaveform(type);
+    }
+
+    Statistics getStatistics() const noexcept
+    {
+        Statistics stats;
+        stats.polyphony = polyphony;
+        stats.activeVoices = activeVoices;
+        stats.peakVoices = peakVoices;
+        stats.voiceSteals = voiceSteals;
+        return stats;
+    }
+
+    void resetStatistics() noexcept
+    {
+        peakVoices = activeVoices.load();
+        voiceSteals = 0;
+    }
+
+protected:
+    juce::SynthesiserVoice* findFreeVoice(juce::SynthesiserSound* soundToPlay, int midiChannel,
+                                          int midiNoteNumber, bool stealIfNoneAvailable) const override
+    {
+        const auto limit = juce::jmin(polyphony.load(), voices.size());
+
+        for (int i = 0; i < limit; ++i)
+        {
+            auto* voice = voices.getUnchecked(i);
+
+            if (!voice->isVoiceActive() && voice->canPlaySound(soundToPlay))
+                return voice;
+        }
+
+        if (stealIfNoneAvailable)
+            return findVoiceToSteal(soundToPlay, midiChannel, midiNoteNumber);
+
+        return nullptr;
+    }
+
+    juce::SynthesiserVoice* findVoiceToSteal(juce::SynthesiserSound* soundToPlay, int,
+                                             int midiNoteNumber) const override
+    {
+        const auto limit = juce::jmin(polyphony.load(), voices.size());
+        juce::SynthesiserVoice* oldestReleased = nullptr;
+        juce::SynthesiserVoice* oldest = nullptr;
+
+        for (int i = 0; i < limit; ++i)
+        {
+            auto* voice = voices.getUnchecked(i);
+
+            if (!voice->canPlaySound(soundToPlay))
+                continue;
+
+            // Retriggering a note reuses the voice already playing it
+            if (voice->getCurrentlyPlayingNote() == midiNoteNumber)
+            {
+                oldest = voice;
+                oldestReleased = nullptr;
+                break;
+            }
+
+            if (voice->isPlayingButReleased()
+                && (oldestReleased == nullptr || voice->wasStartedBefore(*oldestReleased)))
+                oldestReleased = voice;
+
+            if (oldest == nullptr || voice->wasStartedBefore(*oldest))
+                oldest = voice;
+        }
+
+        auto* victim = oldestReleased != nullptr ? oldestReleased : oldest;
+
+        if (victim != nullptr)
+            ++voiceSteals;
+
+        return victim;
+    }
+
+    void renderVoices(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples) override
+    {
+        TRACE_SCOPE("ChordSynthesiser::renderVoices");
+
+        juce::Synthesiser::renderVoices(outputAudio, startSample, numSamples);
+
+        int numActive = 0;
+
+        for (auto* voice : voices)
+            if (voice->isVoiceActive())
+                ++numActive;
+
+        activeVoices = numActive;
+
+        if (numActive > peakVoices)
+            peakVoices = numActive;
+    }
+
+private:
+    std::atomic<int> polyphony { defaultPolyphony };
+    std::atomic<int> activeVoices { 0 };
+    std::atomic<int> peakVoices { 0 };
+    mutable std::atomic<int> voiceSteals { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ChordSynthesiser)
+};
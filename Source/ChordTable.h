@@ -0,0 +1,112 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include "ChordNotes.h"
+#include "KeyManager.h"
+#include "Tracing.h"
+
+//==============================================================================
+// Every chord KeyManager can generate, worked out once.
+// Covers 12 keys x 7 degrees x every voicing, for the diatonic triads and
+// sevenths and for each ChordType. The table is filled from KeyManager's own
+// generate/applyVoicing functions on first use and never changes afterwards,
+// so a lookup is a single indexed load that doesn't allocate and is safe from
+// any thread.
+class ChordTable
+{
+public:
+    static constexpr int numKeys = 12;
+    static constexpr int numDegrees = 7;
+    static constexpr int numChordTypes = static_cast<int>(KeyManager::ChordType::Dominant9) + 1;
+    static constexpr int numVoicings = static_cast<int>(KeyManager::Voicing::Spread) + 1;
+
+    ChordTable()
+    {
+        TRACE_SCOPE("ChordTable::ChordTable");
+
+        KeyManager keyManager;
+
+        for (int key = 0; key < numKeys; ++key)
+        {
+            keyManager.setCurrentKey(static_cast<KeyManager::Key>(key));
+
+            for (int degree = 1; degree <= numDegrees; ++degree)
+            {
+                auto scaleDegree = static_cast<KeyManager::ScaleDegree>(degree);
+                auto triad = keyManager.generateTriad(scaleDegree);
+                auto seventh = keyManager.generateSeventh(scaleDegree);
+
+                for (int voicing = 0; voicing < numVoicings; ++voicing)
+                {
+                    auto v = static_cast<KeyManager::Voicing>(voicing);
+                    triads[getIndex(key, degree, voicing)] = ChordNotes(keyManager.applyVoicing(triad, v));
+                    sevenths[getIndex(key, degree, voicing)] = ChordNotes(keyManager.applyVoicing(seventh, v));
+                }
+
+                for (int type = 0; type < numChordTypes; ++type)
+                {
+                    auto chord = keyManager.generateChord(scaleDegree, static_cast<KeyManager::ChordType>(type));
+
+                    for (int voicing = 0; voicing < numVoicings; ++voicing)
+                        chords[getIndex(key, degree, voicing) * numChordTypes + (size_t) type]
+                            = ChordNotes(keyManager.applyVoicing(chord, static_cast<KeyManager::Voicing>(voicing)));
+                }
+            }
+        }
+    }
+
+    const ChordNotes& getTriad(KeyManager::Key key, KeyManager::ScaleDegree degree,
+                               KeyManager::Voicing voicing) const noexcept
+    {
+        if (!isValidDegree(degree))
+            return empty;
+
+        return triads[getIndex((int) key, (int) degree, (int) voicing)];
+    }
+
+    const ChordNotes& getSeventh(KeyManager::Key key, KeyManager::ScaleDegree degree,
+                                 KeyManager::Voicing voicing) const noexcept
+    {
+        if (!isValidDegree(degree))
+            return empty;
+
+        return sevenths[getIndex((int) key, (int) degree, (int) voicing)];
+    }
+
+    const ChordNotes& getChord(KeyManager::Key key, KeyManager::ScaleDegree degree, KeyManager::ChordType type,
+                               KeyManager::Voicing voicing) const noexcept
+    {
+        if (!isValidDegree(degree))
+            return empty;
+
+        return chords[getIndex((int) key, (int) degree, (int) voicing) * numChordTypes + (size_t) type];
+    }
+
+    // Built on first use; call once at startup so the first lookup doesn't pay for it
+    static const ChordTable& getInstance()
+    {
+        static const ChordTable table;
+        return table;
+    }
+
+private:
+    static constexpr size_t numEntries = (size_t) (numKeys * numDegrees * numVoicings);
+
+    static bool isValidDegree(KeyManager::ScaleDegree degree) noexcept
+    {
+        return (int) degree >= 1 && (int) degree <= numDegrees;
+    }
+
+    static size_t getIndex(int key, int degree, int voicing) noexcept
+    {
+        return (size_t) ((key * numDegrees + degree - 1) * numVoicings + voicing);
+    }
+
+    std::array<ChordNotes, numEntries> triads;
+    std::array<ChordNotes, numEntries> sevenths;
+    std::array<ChordNotes, numEntries * numChordTypes> chords;
+    ChordNotes empty;
+
+    JUCE_DECLARE_NON_COPYABLE(ChordTable)
+};
@@ -0,0 +1,314 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <iostream>
+#include "ProgressionExport.h"
+#include "OfflineRenderer.h"
+
+//==============================================================================
+// Guards the sound of the synth against accidental change. A fixed set of
+// progressions is rendered offline: every emotion, plus every waveform in
+// several time signatures. Each render is reduced to a fingerprint (the RMS
+// and curvature of short windows, the peak and a hash of the samples at 16
+// bits) and compared with the stored golden fingerprints.
+// By default a render must be bit-identical to pass. With --tolerance it
+// passes if every window is within that tolerance instead, so DSP
+// optimisations that only shift rounding can be checked. The RMS follows the
+// level and envelope; the curvature (RMS of the second difference) weights
+// each partial by its frequency squared, so it also follows the waveform's
+// shape, e.g. how the band-limited corners and edges are drawn. The whole
+// run also has to stay under a render time budget per second of audio.
+//
+//   ChordBuilderBenchmarks --golden-check=<file> [--golden-filter=<text>]
+//                          [--tolerance=<relative>] [--max-render-ms=<per second of audio>]
+//   ChordBuilderBenchmarks --golden-update=<file>
+class GoldenRenderCheck
+{
+public:
+    struct Options
+    {
+        juce::File goldenFile;
+        bool update = false;               // Rewrite the golden file instead of checking it
+        juce::String filter;               // Only cases whose name contains this
+        double tolerance = 0.01;           // Relative difference allowed in each window and the peak
+        bool requireIdentical = true;      // Unless a tolerance is given, the hash must match too
+        double maxRenderMsPerSecond = 25.0;
+    };
+
+    struct Case
+    {
+        juce::String name;
+        ProgressionSnapshot progression;
+        OfflineRenderer::Settings settings;
+    };
+
+    struct Fingerprint
+    {
+        juce::Array<juce::var> rms;        // One value per window, mono
+        juce::Array<juce::var> curvature;  // RMS of the second difference, per window
+        double peak = 0.0;
+        juce::String hash;                 // FNV-1a of the samples rounded to 16 bits
+    };
+
+    static constexpr int windowSize = 2048;
+
+    static bool isGoldenCommandLine(const juce::ArgumentList& args)
+    {
+        return args.containsOption("--golden-check") || args.containsOption("--golden-update");
+    }
+
+    static Options parseOptions(const juce::ArgumentList& args)
+    {
+        Options options;
+        options.update = args.containsOption("--golden-update");
+        options.goldenFile = args.getFileForOption(options.update ? "--golden-update" : "--golden-check");
+        options.filter = args.getValueForOption("--golden-filter");
+
+        if (args.containsOption("--tolerance"))
+        {
+            options.tolerance = args.getValueForOption("--tolerance").getDoubleValue();
+            options.requireIdentical = false;
+        }
+
+        if (args.containsOption("--max-render-ms"))
+            options.maxRenderMsPerSecond = args.getValueForOption("--max-render-ms").getDoubleValue();
+
+        return options;
+    }
+
+    //==============================================================================
+    static std::vector<Case> createCases()
+    {
+        KeyManager keyManager;
+        EmotionWheel emotionWheel;
+        std::vector<Case> cases;
+
+        // Short renders at a fast tempo keep the whole set to a few seconds
+        OfflineRenderer::Settings settings;
+        settings.tempo = 240.0;
+        settings.tailSeconds = 0.25;
+
+        // Every emotion, on I and V so both a low and a high root are covered
+        for (auto emotion : emotionWheel.getAllEmotions())
+        {
+            const auto name = EmotionWheel::getEmotionName(emotion);
+
+            Case emotionCase;
+            emotionCase.name = "emotion/" + juce::String::fromUTF8(name.data(), (int) name.size());
+            emotionCase.progression = ProgressionExport::buildProgression(keyManager, emotionWheel, { 1, 5 },
+                                                                          { emotion, emotion }, false,
+                                                                          KeyManager::Voicing::Close);
+            emotionCase.settings = settings;
+            cases.push_back(emotionCase);
+        }
+
+        // Every waveform in every time signature the app offers
+        const auto progression = ProgressionExport::buildProgression(keyManager, emotionWheel, { 1, 5, 6, 4 }, {},
+                                                                     true, KeyManager::Voicing::Open);
+        const juce::StringArray waveformNames { "Sine", "Sawtooth", "Square", "Triangle" };
+        const std::pair<int, int> timeSignatures[] { { 4, 4 }, { 3, 4 }, { 6, 8 }, { 5, 4 }, { 7, 8 }, { 2, 4 } };
+
+        for (int waveform = 0; waveform < waveformNames.size(); ++waveform)
+        {
+            for (const auto& [beatsPerMeasure, beatUnit] : timeSignatures)
+            {
+                Case waveformCase;
+                waveformCase.name = "waveform/" + waveformNames[waveform] + "/"
+                                  + juce::String(beatsPerMeasure) + "-" + juce::String(beatUnit);
+                waveformCase.progression = progression;
+                waveformCase.settings = settings;
+                waveformCase.settings.waveform = static_cast<WaveformType>(waveform);
+                waveformCase.settings.beatsPerMeasure = beatsPerMeasure;
+                waveformCase.settings.beatUnit = beatUnit;
+                cases.push_back(waveformCase);
+            }
+        }
+
+        return cases;
+    }
+
+    static Fingerprint createFingerprint(const juce::AudioBuffer<float>& buffer)
+    {
+        Fingerprint fingerprint;
+        juce::uint64 hash = 14695981039346656037ull;
+        const auto numChannels = buffer.getNumChannels();
+        double previous = 0.0, slope = 0.0;
+
+        for (int start = 0; start < buffer.getNumSamples(); start += windowSize)
+        {
+            const auto numSamples = juce::jmin(windowSize, buffer.getNumSamples() - start);
+            double sumOfSquares = 0.0, sumOfCurvatureSquares = 0.0;
+
+            for (int i = start; i < start + numSamples; ++i)
+            {
+                double mono = 0.0;
+
+                for (int channel = 0; channel < numChannels; ++channel)
+                {
+                    const auto sample = buffer.getSample(channel, i);
+                    const auto quantised = (juce::uint16) juce::jlimit(-32768, 32767, juce::roundToInt(sample * 32767.0f));
+                    hash = (hash ^ quantised) * 1099511628211ull;
+                    mono += sample;
+                }
+
+                mono /= numChannels;
+                sumOfSquares += mono * mono;
+                fingerprint.peak = juce::jmax(fingerprint.peak, std::abs(mono));
+
+                const auto curvature = (mono - previous) - slope;
+                sumOfCurvatureSquares += curvature * curvature;
+                slope = mono - previous;
+                previous = mono;
+            }
+
+            fingerprint.rms.add(std::sqrt(sumOfSquares / numSamples));
+            fingerprint.curvature.add(std::sqrt(sumOfCurvatureSquares / numSamples));
+        }
+
+        fingerprint.hash = juce::String::toHexString((juce::int64) hash);
+        return fingerprint;
+    }
+
+    //==============================================================================
+    // Returns the process exit code
+    static int run(const Options& options)
+    {
+        juce::var golden;
+
+        if (!options.update)
+        {
+            const auto parseResult = juce::JSON::parse(options.goldenFile.loadFileAsString(), golden);
+
+            if (parseResult.failed() || !golden.isObject())
+            {
+                std::cerr << "Couldn't read golden renders from " << options.goldenFile.getFullPathName() << std::endl;
+                return 1;
+            }
+        }
+
+        auto* updated = new juce::DynamicObject();
+        juce::var updatedGolden(updated);
+        int numChecked = 0, numFailed = 0, numIdentical = 0;
+        double totalRenderSeconds = 0.0, totalAudioSeconds = 0.0;
+
+        for (const auto& renderCase : createCases())
+        {
+            if (options.filter.isNotEmpty() && !renderCase.name.containsIgnoreCase(options.filter))
+                continue;
+
+            juce::AudioBuffer<float> buffer;
+            const auto start = juce::Time::getHighResolutionTicks();
+            OfflineRenderer::renderToBuffer(renderCase.progression, renderCase.settings, buffer);
+            totalRenderSeconds += juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+            totalAudioSeconds += buffer.getNumSamples() / renderCase.settings.sampleRate;
+
+            const auto fingerprint = createFingerprint(buffer);
+            ++numChecked;
+
+            if (options.update)
+            {
+                auto* entry = new juce::DynamicObject();
+                entry->setProperty("rms", fingerprint.rms);
+                entry->setProperty("curvature", fingerprint.curvature);
+                entry->setProperty("peak", fingerprint.peak);
+                entry->setProperty("hash", fingerprint.hash);
+                updated->setProperty(renderCase.name, juce::var(entry));
+                continue;
+            }
+
+            const auto& expected = golden[juce::Identifier(renderCase.name)];
+            const auto isIdentical = fingerprint.hash == expected["hash"].toString();
+            auto difference = compare(fingerprint, expected, options.tolerance);
+
+            if (difference.isEmpty() && !isIdentical && options.requireIdentical)
+                difference = "samples differ from the golden render (give --tolerance to allow small differences)";
+
+            if (difference.isNotEmpty())
+            {
+                std::cout << "FAIL " << renderCase.name << ": " << difference << std::endl;
+                ++numFailed;
+            }
+            else if (isIdentical)
+            {
+                ++numIdentical;
+            }
+        }
+
+        const auto renderMsPerSecond = totalAudioSeconds > 0.0 ? totalRenderSeconds * 1000.0 / totalAudioSeconds : 0.0;
+        std::cout << "Rendered " << numChecked << " cases, " << juce::String(totalAudioSeconds, 1) << " s of audio in "
+                  << juce::String(totalRenderSeconds * 1000.0, 1) << " ms (" << juce::String(renderMsPerSecond, 2)
+                  << " ms per second of audio)" << std::endl;
+
+        if (options.update)
+        {
+            if (!options.goldenFile.replaceWithText(juce::JSON::toString(updatedGolden)))
+            {
+                std::cerr << "Couldn't write " << options.goldenFile.getFullPathName() << std::endl;
+                return 1;
+            }
+
+            std::cout << "Wrote " << options.goldenFile.getFullPathName() << std::endl;
+            return 0;
+        }
+
+        std::cout << (numChecked - numFailed) << " of " << numChecked << " match, " << numIdentical
+                  << " bit-identical" << std::endl;
+
+        if (renderMsPerSecond > options.maxRenderMsPerSecond)
+        {
+            std::cout << "FAIL render time " << juce::String(renderMsPerSecond, 2) << " ms per second of audio is over the "
+                      << juce::String(options.maxRenderMsPerSecond, 2) << " ms budget" << std::endl;
+            ++numFailed;
+        }
+
+        return numFailed > 0 ? 1 : 0;
+    }
+
+private:
+    // Describes the first difference beyond tolerance, or returns an empty string
+    static juce::String compare(const Fingerprint& fingerprint, const juce::var& expected, double tolerance)
+    {
+        if (!expected.isObject())
+            return "no golden render";
+
+        const auto* expectedRms = expected["rms"].getArray();
+        const auto* expectedCurvature = expected["curvature"].getArray();
+
+        if (expectedRms == nullptr || expectedRms->size() != fingerprint.rms.size()
+            || expectedCurvature == nullptr || expectedCurvature->size() != fingerprint.curvature.size())
+            return "length changed";
+
+        auto isClose = [tolerance](double actual, double reference) {
+            return std::abs(actual - reference) <= absoluteTolerance + tolerance * std::abs(reference);
+        };
+
+        auto compareWindows = [&isClose](const juce::String& name, const juce::Array<juce::var>& actualValues,
+                                         const juce::Array<juce::var>& expectedValues) -> juce::String {
+            for (int window = 0; window < actualValues.size(); ++window)
+            {
+                const auto actual = (double) actualValues[window];
+                const auto reference = (double) expectedValues[window];
+
+                if (!isClose(actual, reference))
+                    return name + " of window " + juce::String(window) + " (from " + juce::String(window * windowSize)
+                         + " samples) is " + juce::String(actual, 6) + ", expected " + juce::String(reference, 6);
+            }
+
+            return {};
+        };
+
+        if (auto difference = compareWindows("RMS", fingerprint.rms, *expectedRms); difference.isNotEmpty())
+            return difference;
+
+        if (auto difference = compareWindows("Curvature", fingerprint.curvature, *expectedCurvature); difference.isNotEmpty())
+            return difference;
+
+        if (!isClose(fingerprint.peak, (double) expected["peak"]))
+            return "peak is " + juce::String(fingerprint.peak, 6) + ", expected " + juce::String((double) expected["peak"], 6);
+
+        return {};
+    }
+
+    // Lets near-silent windows differ by rounding noise
+    static constexpr double absoluteTolerance = 1.0e-5;
+};
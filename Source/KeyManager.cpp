@@ -1,4 +1,6 @@
 #include "KeyManager.h"
+#include "ChordTable.h"
+#include "Tracing.h"
 
 //==============================================================================
 // KeyManager Implementation
@@ -68,8 +70,22 @@ std::vector<std::string> KeyManager::getChromaticNoteNames() const
 
 bool KeyManager::isNoteInKey(int note) const
 {
-    auto scaleNotes = getScaleNotes();
-    return std::find(scaleNotes.begin(), scaleNotes.end(), note % 12) != scaleNotes.end();
+    return getScale().contains(note);
+}
+
+PitchClassSet KeyManager::getScale() const
+{
+    return majorScale.transposed(static_cast<int>(currentKey));
+}
+
+PitchClassSet KeyManager::getChordPitchClasses(ChordType type) const
+{
+    return PitchClassSet::fromNotes(getChordIntervals(type));
+}
+
+bool KeyManager::isChordInKey(PitchClassSet chord) const
+{
+    return chord.isSubsetOf(getScale());
 }
 
 std::vector<int> KeyManager::generateTriad(ScaleDegree degree) const
@@ -159,6 +175,21 @@ std::vector<int> KeyManager::generateChord(ScaleDegree degree, ChordType type) c
     return chord;
 }
 
+const ChordNotes& KeyManager::getTriad(ScaleDegree degree, Voicing voicing) const
+{
+    return ChordTable::getInstance().getTriad(currentKey, degree, voicing);
+}
+
+const ChordNotes& KeyManager::getSeventh(ScaleDegree degree, Voicing voicing) const
+{
+    return ChordTable::getInstance().getSeventh(currentKey, degree, voicing);
+}
+
+const ChordNotes& KeyManager::getChord(ScaleDegree degree, ChordType type, Voicing voicing) const
+{
+    return ChordTable::getInstance().getChord(currentKey, degree, type, voicing);
+}
+
 std::vector<std::vector<int>> KeyManager::generateProgression(const std::vector<ScaleDegree>& degrees) const
 {
     return generateProgression(degrees, false); // Default to triads
@@ -166,6 +197,8 @@ std::vector<std::vector<int>> KeyManager::generateProgression(const std::vector<
 
 std::vector<std::vector<int>> KeyManager::generateProgression(const std::vector<ScaleDegree>& degrees, bool useSevenths) const
 {
+    TRACE_SCOPE("KeyManager::generateProgression");
+    
     std::vector<std::vector<int>> progression;
     
     for (ScaleDegree degree : degrees)
@@ -195,6 +228,8 @@ std::vector<std::vector<int>> KeyManager::getCommonProgression(const std::string
 
 std::vector<std::vector<int>> KeyManager::getCommonProgression(const std::string& progressionName, bool useSevenths, Voicing voicing) const
 {
+    TRACE_SCOPE("KeyManager::getCommonProgression");
+    
     auto it = commonProgressions.find(progressionName);
     if (it != commonProgressions.end())
     {
@@ -214,6 +249,8 @@ std::vector<std::vector<int>> KeyManager::getCommonProgression(const std::string
 
 std::vector<int> KeyManager::applyVoicing(const std::vector<int>& chord, Voicing voicing) const
 {
+    TRACE_SCOPE("KeyManager::applyVoicing");
+    
     if (chord.empty()) return chord;
     
     std::vector<int> voicedChord = chord;
@@ -330,7 +367,12 @@ KeyManager::ChordType KeyManager::analyzeSeventh(ScaleDegree degree) const
 
 std::string KeyManager::getChordName(ScaleDegree degree, ChordType type) const
 {
-    std::string rootName = noteNames[getNoteFromDegree(degree)];
+    return getChordNameForRoot(getNoteFromDegree(degree), type);
+}
+
+std::string KeyManager::getChordNameForRoot(int rootPitchClass, ChordType type) const
+{
+    std::string rootName = noteNames[(size_t) (((rootPitchClass % 12) + 12) % 12)];
     
     switch (type)
     {
@@ -368,14 +410,11 @@ int KeyManager::getNoteFromDegree(ScaleDegree degree) const
 
 KeyManager::ScaleDegree KeyManager::getDegreeFromNote(int note) const
 {
-    auto scaleNotes = getScaleNotes();
-    auto it = std::find(scaleNotes.begin(), scaleNotes.end(), note % 12);
+    // Position within the major scale, measured from the key's root
+    int step = majorScale.indexOf(note - static_cast<int>(currentKey));
     
-    if (it != scaleNotes.end())
-    {
-        int index = std::distance(scaleNotes.begin(), it);
-        return static_cast<ScaleDegree>(index + 1);
-    }
+    if (step >= 0)
+        return static_cast<ScaleDegree>(step + 1);
     
     return ScaleDegree::I; // Default
 }
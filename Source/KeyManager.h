@@ -4,6 +4,8 @@
 #include <vector>
 #include <string>
 #include <map>
+#include "ChordNotes.h"
+#include "PitchClassSet.h"
 
 class KeyManager
 {
@@ -64,11 +66,22 @@ public:
     std::vector<std::string> getChromaticNoteNames() const;
     bool isNoteInKey(int note) const;
     
+    // Pitch-class set versions: key membership and transposition are bit operations
+    static constexpr PitchClassSet majorScale { 0, 2, 4, 5, 7, 9, 11 };
+    PitchClassSet getScale() const;
+    PitchClassSet getChordPitchClasses(ChordType type) const;  // Intervals from C
+    bool isChordInKey(PitchClassSet chord) const;
+    
     // Chord generation functions
     std::vector<int> generateTriad(ScaleDegree degree) const;
     std::vector<int> generateSeventh(ScaleDegree degree) const;
     std::vector<int> generateChord(ScaleDegree degree, ChordType type) const;
     
+    // Precomputed chords for the current key; no allocation (see ChordTable)
+    const ChordNotes& getTriad(ScaleDegree degree, Voicing voicing = Voicing::Close) const;
+    const ChordNotes& getSeventh(ScaleDegree degree, Voicing voicing = Voicing::Close) const;
+    const ChordNotes& getChord(ScaleDegree degree, ChordType type, Voicing voicing = Voicing::Close) const;
+    
     // Chord progression functions
     std::vector<std::vector<int>> generateProgression(const std::vector<ScaleDegree>& degrees) const;
     std::vector<std::vector<int>> generateProgression(const std::vector<ScaleDegree>& degrees, bool useSevenths) const;
@@ -83,6 +96,7 @@ public:
     ChordType analyzeTriad(ScaleDegree degree) const;
     ChordType analyzeSeventh(ScaleDegree degree) const;
     std::string getChordName(ScaleDegree degree, ChordType type) const;
+    std::string getChordNameForRoot(int rootPitchClass, ChordType type) const;
     
     // Utility functions
     int getNoteFromDegree(ScaleDegree degree) const;
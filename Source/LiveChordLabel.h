@@ -0,0 +1,61 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "ChordRecognizer.h"
+#include "KeyManager.h"
+#include "LiveMidiInput.h"
+
+//==============================================================================
+// Names the chord being played on the MIDI controllers, e.g. "Playing Am7".
+// Polls LiveMidiInput's sounding notes and only looks the chord up again when
+// they change.
+class LiveChordLabel : public juce::Label,
+                       private juce::Timer
+{
+public:
+    LiveChordLabel(const LiveMidiInput& input, const KeyManager& keys)
+        : liveMidiInput(input), keyManager(keys)
+    {
+        setFont(juce::FontOptions(14.0f, juce::Font::bold));
+        setJustificationType(juce::Justification::centredLeft);
+        startTimerHz(20);
+    }
+
+private:
+    void timerCallback() override
+    {
+        const auto notes = liveMidiInput.getSoundingNotes();
+
+        if (notes == shownNotes)
+            return;
+
+        shownNotes = notes;
+        const auto match = ChordRecognizer::getInstance().recognise(notes.pitchClasses, notes.lowestNote);
+
+        if (!match.isValid())
+        {
+            setText("", juce::dontSendNotification);
+            return;
+        }
+
+        // A single note or an interval is only the nearest chord, so mark it as approximate
+        auto text = juce::String::fromUTF8(keyManager.getChordNameForRoot(match.root, match.type).c_str());
+
+        if (!match.isExact())
+            text = "~" + text;
+
+        if (match.emotionDistance == 0)
+        {
+            auto name = EmotionWheel::getEmotionName(match.emotion);
+            text << "  " << juce::String::fromUTF8(name.data(), (int) name.size());
+        }
+
+        setText("Playing " + text, juce::dontSendNotification);
+    }
+
+    const LiveMidiInput& liveMidiInput;
+    const KeyManager& keyManager;
+    LiveMidiInput::SoundingNotes shownNotes;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LiveChordLabel)
+};
@@ -0,0 +1,250 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include "ChordNotes.h"
+#include "KeyManager.h"
+#include "LockFreeFifo.h"
+#include "TransportSync.h"
+
+//==============================================================================
+// Chords for each scale degree of the current key, built on the message
+// thread and handed to the audio thread through LiveMidiInput's map queue
+struct LiveChordMap
+{
+    static constexpr int numDegrees = 7;
+
+    int key = 0;                 // Pitch class of the tonic
+    bool chordMode = true;       // One-finger chords; false passes notes straight through
+    std::array<ChordNotes, numDegrees> chords {};  // Index 0 is degree I
+    std::array<int, numDegrees> roots {};          // Note each chord is rooted on
+};
+
+//==============================================================================
+// Plays MIDI controllers through the synth without a message-thread hop.
+// Device threads push incoming messages into a FIFO with their timestamps;
+// the audio callback drains it, places each message at its sample offset in
+// the block and, in chord mode, swaps a diatonic note for the current key's
+// chord for that degree (rooted on the note played). MIDI clock drives a
+// MidiClockFollower instead of the synth, for syncing playback to another
+// device. Nothing on the audio side blocks or allocates.
+class LiveMidiInput : public juce::MidiInputCallback
+{
+public:
+    static constexpr int midiChannel = 2;  // Keeps live notes apart from playback and previews
+
+    // What the live input is sounding, for naming the chord in the UI
+    struct SoundingNotes
+    {
+        PitchClassSet pitchClasses;
+        int lowestNote = -1;  // -1 when nothing is sounding
+
+        bool operator==(const SoundingNotes& other) const noexcept
+        {
+            return pitchClasses == other.pitchClasses && lowestNote == other.lowestNote;
+        }
+
+        bool operator!=(const SoundingNotes& other) const noexcept  { return !(*this == other); }
+    };
+
+    LiveMidiInput() = default;
+
+    // Call from prepareToPlay
+    void prepare(double newSampleRate) noexcept
+    {
+        sampleRate = newSampleRate;
+        lastBlockTime = juce::Time::getMillisecondCounterHiRes() * 0.001;
+    }
+
+    // Message thread: swap in chords for a new key, progression or mode
+    void setChordMap(const LiveChordMap& map) noexcept
+    {
+        chordMaps.push(map);
+    }
+
+    // MIDI device threads. Several devices may call this at once, so
+    // producers take a lock; the audio thread never does.
+    void handleIncomingMidiMessage(juce::MidiInput*, const juce::MidiMessage& message) override
+    {
+        if (!(message.isNoteOnOrOff() || message.isController() || message.isPitchWheel()
+              || message.isMidiClock() || message.isMidiStart() || message.isMidiStop()
+              || message.isMidiContinue() || message.isSongPositionPointer()))
+            return;
+
+        const juce::SpinLock::ScopedLockType lock(producerLock);
+        incoming.push(message);
+    }
+
+    // Audio thread: adds this block's live notes to the synth's buffer
+    void renderNextBlock(juce::MidiBuffer& midi, int numSamples) noexcept
+    {
+        while (chordMaps.pop(chordMap)) {}
+
+        // Messages are timestamped in seconds on the same clock. Spread the
+        // time since the last block over this one so the spacing between
+        // notes is kept and the added latency is a steady one block.
+        const auto blockTime = juce::Time::getMillisecondCounterHiRes() * 0.001;
+        const auto elapsedSamples = juce::jmax(1.0, (blockTime - lastBlockTime) * sampleRate);
+        const auto scale = numSamples / elapsedSamples;
+        juce::MidiMessage message;
+
+        while (incoming.pop(message))
+        {
+            if (clock.handleMessage(message, message.getTimeStamp()))
+                continue;
+
+            const auto position = (message.getTimeStamp() - lastBlockTime) * sampleRate * scale;
+            const int sampleOffset = juce::jlimit(0, juce::jmax(0, numSamples - 1), (int) position);
+
+            if (message.isNoteOn())
+                noteOn(midi, message.getNoteNumber(), message.getFloatVelocity(), sampleOffset);
+            else if (message.isNoteOff())
+                noteOff(midi, message.getNoteNumber(), sampleOffset);
+            else
+            {
+                message.setChannel(midiChannel);
+                midi.addEvent(message, sampleOffset);
+            }
+        }
+
+        // Sample 0 of this block stands for the previous block's time
+        blockStartTime = lastBlockTime;
+        lastBlockTime = blockTime;
+
+        if (soundingChanged)
+            publishSoundingNotes();
+    }
+
+    // Audio thread, after renderNextBlock: the MIDI clock's position at the
+    // start of the block
+    TransportPosition getClockPosition(int beatsPerMeasure, int beatUnit) noexcept
+    {
+        clock.setTimeSignature(beatsPerMeasure, beatUnit);
+        return clock.getPosition(blockStartTime);
+    }
+
+    // Audio thread: releases everything still held, e.g. when the device stops
+    void allNotesOff(juce::MidiBuffer& midi, int sampleOffset) noexcept
+    {
+        for (int note = 0; note < 128; ++note)
+        {
+            if (soundingCounts[(size_t) note] > 0)
+                midi.addEvent(juce::MidiMessage::noteOff(midiChannel, note), sampleOffset);
+
+            soundingCounts[(size_t) note] = 0;
+            heldChords[(size_t) note].clear();
+        }
+
+        publishSoundingNotes();
+    }
+
+    // Any thread. Updated once per audio block.
+    SoundingNotes getSoundingNotes() const noexcept
+    {
+        const auto packed = soundingNotes.load(std::memory_order_relaxed);
+
+        SoundingNotes notes;
+        notes.pitchClasses = PitchClassSet::fromBits(packed & PitchClassSet::allBits);
+        notes.lowestNote = (int) (packed >> 16) - 1;
+        return notes;
+    }
+
+private:
+    void noteOn(juce::MidiBuffer& midi, int note, float velocity, int sampleOffset) noexcept
+    {
+        // A retriggered key releases what it was holding first
+        noteOff(midi, note, sampleOffset);
+
+        auto& chord = heldChords[(size_t) note];
+        chord = getChordForNote(note);
+
+        for (int chordNote : chord)
+        {
+            // The synth retriggers a note that is already sounding, so only count it
+            ++soundingCounts[(size_t) chordNote];
+            soundingChanged = true;
+            midi.addEvent(juce::MidiMessage::noteOn(midiChannel, chordNote, velocity), sampleOffset);
+        }
+    }
+
+    void noteOff(juce::MidiBuffer& midi, int note, int sampleOffset) noexcept
+    {
+        auto& chord = heldChords[(size_t) note];
+
+        // Chords can share notes, so a note stops when the last key using it is released
+        for (int chordNote : chord)
+        {
+            if (soundingCounts[(size_t) chordNote] > 0 && --soundingCounts[(size_t) chordNote] == 0)
+            {
+                midi.addEvent(juce::MidiMessage::noteOff(midiChannel, chordNote), sampleOffset);
+                soundingChanged = true;
+            }
+        }
+
+        chord.clear();
+    }
+
+    // Packs the sounding pitch classes and lowest note into one atomic
+    void publishSoundingNotes() noexcept
+    {
+        PitchClassSet pitchClasses;
+        int lowestNote = -1;
+
+        for (int note = 127; note >= 0; --note)
+        {
+            if (soundingCounts[(size_t) note] > 0)
+            {
+                pitchClasses = pitchClasses.with(note);
+                lowestNote = note;
+            }
+        }
+
+        soundingNotes.store((juce::uint32) pitchClasses.getBits() | ((juce::uint32) (lowestNote + 1) << 16),
+                            std::memory_order_relaxed);
+        soundingChanged = false;
+    }
+
+    ChordNotes getChordForNote(int note) const noexcept
+    {
+        ChordNotes result;
+        const int degree = KeyManager::majorScale.indexOf(note - chordMap.key);
+
+        if (!chordMap.chordMode || degree < 0 || chordMap.chords[(size_t) degree].isEmpty())
+        {
+            // Notes outside the key still sound, on their own
+            result.add(note);
+            return result;
+        }
+
+        // Same pitch class as the chord's root, so this is whole octaves
+        const int shift = note - chordMap.roots[(size_t) degree];
+
+        for (int chordNote : chordMap.chords[(size_t) degree])
+            result.add(chordNote + shift);
+
+        return result;
+    }
+
+    // Shared with the device threads
+    LockFreeFifo<juce::MidiMessage, 512> incoming;
+    juce::SpinLock producerLock;
+
+    // Message thread -> audio thread
+    LockFreeFifo<LiveChordMap, 8> chordMaps;
+
+    // Audio thread -> message thread, packed by publishSoundingNotes()
+    std::atomic<juce::uint32> soundingNotes { 0 };
+
+    // Audio thread only
+    LiveChordMap chordMap;
+    MidiClockFollower clock;
+    std::array<ChordNotes, 128> heldChords {};   // What each input key is holding
+    std::array<int, 128> soundingCounts {};      // Keys holding each output note
+    double sampleRate = 44100.0;
+    double lastBlockTime = 0.0;
+    double blockStartTime = 0.0;
+    bool soundingChanged = false;
+
+    JUCE_DECLARE_NON_COPYABLE(LiveMidiInput)
+};
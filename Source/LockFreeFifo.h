@@ -0,0 +1,52 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+
+//==============================================================================
+// Single-producer / single-consumer queue of preallocated items.
+// Built on juce::AbstractFifo so neither side ever blocks or allocates; the
+// producer and consumer must each stay on one thread.
+template <typename ItemType, int capacity>
+class LockFreeFifo
+{
+public:
+    LockFreeFifo() = default;
+
+    // Producer side. Returns false (and drops the item) if the queue is full.
+    bool push(const ItemType& item) noexcept
+    {
+        const auto scope = fifo.write(1);
+
+        if (scope.blockSize1 > 0)
+        {
+            items[(size_t) scope.startIndex1] = item;
+            return true;
+        }
+
+        return false;
+    }
+
+    // Consumer side. Returns false if there was nothing to read.
+    bool pop(ItemType& item) noexcept
+    {
+        const auto scope = fifo.read(1);
+
+        if (scope.blockSize1 > 0)
+        {
+            item = items[(size_t) scope.startIndex1];
+            return true;
+        }
+
+        return false;
+    }
+
+    int getNumReady() const noexcept    { return fifo.getNumReady(); }
+    int getFreeSpace() const noexcept   { return fifo.getFreeSpace(); }
+
+private:
+    juce::AbstractFifo fifo { capacity };
+    std::array<ItemType, (size_t) capacity> items {};
+
+    JUCE_DECLARE_NON_COPYABLE(LockFreeFifo)
+};
@@ -8,6 +8,8 @@
 
 #include <JuceHeader.h>
 #include "MainComponent.h"
+#include "BatchGenerator.h"
+#include "Tracing.h"
 
 //==============================================================================
 class NewProjectApplication  : public juce::JUCEApplication
@@ -25,6 +27,26 @@ public:
     {
         // This method is where you should put your application's initialisation code..
 
+        // Headless batch mode: generate files and exit without opening a window
+        juce::ArgumentList args (getApplicationName(), getCommandLineParameterArray());
+
+        if (BatchGenerator::isHeadlessCommandLine (args))
+        {
+            setApplicationReturnValue (BatchGenerator::run (args));
+            quit();
+            return;
+        }
+
+       #if CHORD_BUILDER_ENABLE_TRACING
+        // Tracing builds record from launch to quit; --trace=<file> picks where
+        auto traceFile = args.containsOption ("--trace")
+                           ? juce::File::getCurrentWorkingDirectory().getChildFile (args.getValueForOption ("--trace"))
+                           : juce::File::getSpecialLocation (juce::File::userDocumentsDirectory).getChildFile ("chord_builder_trace.json");
+
+        if (Tracer::getInstance().start (traceFile))
+            DBG ("Tracing to " << traceFile.getFullPathName());
+       #endif
+
         mainWindow.reset (new MainWindow (getApplicationName()));
     }
 
@@ -33,6 +55,10 @@ public:
         // Add your application's shutdown code here..
 
         mainWindow = nullptr; // (deletes our window)
+
+       #if CHORD_BUILDER_ENABLE_TRACING
+        Tracer::getInstance().stop();
+       #endif
     }
 
     //==============================================================================
@@ -3,6 +3,8 @@
 //==============================================================================
 MainComponent::MainComponent() : keyboard(keyboardState, juce::MidiKeyboardComponent::horizontalKeyboard)
 {
+    TRACE_SCOPE("MainComponent::MainComponent");
+    
     keyComboBox.addItem("C", 1);
     keyComboBox.addItem("C#", 2);
     keyComboBox.addItem("D", 3);
@@ -53,10 +55,7 @@ MainComponent::MainComponent() : keyboard(keyboardState, juce::MidiKeyboardCompo
     timeSignatureComboBox.setSelectedId(1);
     timeSignatureComboBox.onChange = [this] { 
         updateTimeSignature();
-        if (isPlaying)
-        {
-            updateChordDuration();
-        }
+        publishPlaybackSettings();
     };
     addAndMakeVisible(timeSignatureComboBox);
     
@@ -85,9 +84,47 @@ MainComponent::MainComponent() : keyboard(keyboardState, juce::MidiKeyboardCompo
     
     loopButton.setButtonText("Loop");
     loopButton.setToggleState(false, juce::dontSendNotification);
-    loopButton.onClick = [this] { shouldLoop = loopButton.getToggleState(); };
+    loopButton.onClick = [this] { publishPlaybackSettings(); };
     addAndMakeVisible(loopButton);
     
+    voiceLeadingButton.setButtonText("Smooth");
+    voiceLeadingButton.setToggleState(false, juce::dontSendNotification);
+    voiceLeadingButton.onClick = [this] { refreshPlayingProgression(); };
+    addAndMakeVisible(voiceLeadingButton);
+    
+    // Notes from MIDI controllers trigger the chord for their scale degree
+    midiChordModeButton.setButtonText("MIDI Chords");
+    midiChordModeButton.setToggleState(true, juce::dontSendNotification);
+    midiChordModeButton.onClick = [this] { updateLiveChordMap(); };
+    addAndMakeVisible(midiChordModeButton);
+    addAndMakeVisible(liveChordLabel);
+    
+    // Playback can drive the built-in synth, an external MIDI port, or both
+    outputModeComboBox.addItem("Synth", static_cast<int>(OutputMode::Synth));
+    outputModeComboBox.addItem("MIDI Out", static_cast<int>(OutputMode::MidiOut));
+    outputModeComboBox.addItem("Synth + MIDI", static_cast<int>(OutputMode::Both));
+    outputModeComboBox.setSelectedId(static_cast<int>(OutputMode::Synth), juce::dontSendNotification);
+    outputModeComboBox.onChange = [this] { midiOutputChanged(); };
+    addAndMakeVisible(outputModeComboBox);
+    
+    midiOutputComboBox.setTextWhenNothingSelected("MIDI Output");
+    midiOutputComboBox.onChange = [this] { midiOutputChanged(); };
+    addAndMakeVisible(midiOutputComboBox);
+    refreshMidiOutputs();
+    midiOutputComboBox.setEnabled(false);  // Until a MIDI output mode is chosen
+    
+    // Playback can follow MIDI clock from another device instead of the tempo field
+    syncComboBox.addItem("Internal Clock", 1);
+    syncComboBox.addItem("MIDI Clock", 2);
+    syncComboBox.setSelectedId(1, juce::dontSendNotification);
+    syncComboBox.onChange = [this] { publishPlaybackSettings(); };
+    addAndMakeVisible(syncComboBox);
+    
+    // Audio callback load and dropout figures, shown over the bottom of the window
+    statsButton.setButtonText("Stats");
+    statsButton.onClick = [this] { callbackMonitorOverlay.setVisible(statsButton.getToggleState()); };
+    addAndMakeVisible(statsButton);
+    
     // Setup tempo as an editable text field
     tempoEditor.setText("120", juce::dontSendNotification);
     tempoEditor.setEditable(true);
@@ -95,7 +132,7 @@ MainComponent::MainComponent() : keyboard(keyboardState, juce::MidiKeyboardCompo
     tempoEditor.onTextChange = [this]() {
         int tempo = tempoEditor.getText().getIntValue();
         if (tempo >= 60 && tempo <= 200) {
-            updateChordDuration();
+            publishPlaybackSettings();
         }
     };
     addAndMakeVisible(tempoEditor);
@@ -108,6 +145,11 @@ MainComponent::MainComponent() : keyboard(keyboardState, juce::MidiKeyboardCompo
     midiDragButton.addMouseListener(this, false);
     addAndMakeVisible(midiDragButton);
     
+    // Audio export button
+    exportAudioButton.setButtonText("Export Audio");
+    exportAudioButton.onClick = [this] { exportAudio(); };
+    addAndMakeVisible(exportAudioButton);
+    
     // Setup emotion buttons
     for (int i = 0; i < 24; ++i)
     {
@@ -164,11 +206,12 @@ MainComponent::MainComponent() : keyboard(keyboardState, juce::MidiKeyboardCompo
     
     // Initialize playback state
     isPlaying = false;
-    shouldLoop = false;
-    currentChordIndex = 0;
-    samplesUntilNextChord = 0;
     beatsPerMeasure = 4;
     beatUnit = 4;
+    publishPlaybackSettings();
+    
+    // Polls for the end of playback and export progress
+    startTimerHz(20);
     
     // Detect system audio devices first
     detectSystemAudioDevices();
@@ -176,12 +219,11 @@ MainComponent::MainComponent() : keyboard(keyboardState, juce::MidiKeyboardCompo
     // Try to initialize audio device
     tryInitializeAudioDevice();
     
-    // Setup synthesizer with sine wave voices
-    for (int i = 0; i < 16; ++i)
-        synth.addVoice(new SineWaveVoice());
+    // Build every chord up front so the first hover doesn't pay for it
+    ChordTable::getInstance();
     
-    // Add a simple sine wave sound for all notes
-    synth.addSound(new SineWaveSound());
+    // The synth preallocates its voice pool; this sets how many may sound at once
+    synth.setPolyphony(ChordSynthesiser::defaultPolyphony);
     
     updateDisplay();
     updateChordButtonLabels();  // Initialize chord button labels with notes
@@ -189,6 +231,8 @@ MainComponent::MainComponent() : keyboard(keyboardState, juce::MidiKeyboardCompo
     
     // Initialize audio with 0 input channels and 2 output channels
     setAudioChannels(0, 2);
+    enableMidiInputs();
+    updateLiveChordMap();
     
     // Debug audio device information
     auto* audioDeviceManager = &deviceManager;
@@ -250,17 +294,25 @@ MainComponent::MainComponent() : keyboard(keyboardState, juce::MidiKeyboardCompo
     }
     themeManager.setTheme(ThemeManager::Theme::Default);  // Temporarily disabled
     applyTheme();  // Temporarily disabled
+    
+    // Added last so it sits above everything else
+    addChildComponent(callbackMonitorOverlay);
 }
 
 MainComponent::~MainComponent()
 {
     // Reset LookAndFeel to avoid dangling pointer
     chordButtons[0].setLookAndFeel(nullptr);
+    stopTimer();
+    exportThread.reset();  // Cancels an unfinished export
+    deviceManager.removeMidiInputDeviceCallback({}, &liveMidiInput);
     shutdownAudio();
 }
 
 // Temporarily disabled - ThemeManager not yet in build
 void MainComponent::applyTheme() {
+    TRACE_SCOPE("MainComponent::applyTheme");
+    
     const auto& colors = themeManager.getColors();
 
     // Set background
@@ -344,94 +396,107 @@ void MainComponent::prepareToPlay (int samplesPerBlockExpected, double sampleRat
     // Debug output
     DBG("Audio prepared - Sample Rate: " << sampleRate << ", Block Size: " << samplesPerBlockExpected);
     
-    synth.setCurrentPlaybackSampleRate(sampleRate);
+    // Sets the voices' sample rate and sizes their render buffers
+    synth.prepare(sampleRate, samplesPerBlockExpected);
     this->sampleRate = sampleRate;
     
-    // Calculate samples per beat based on initial tempo
-    samplesPerBeat = static_cast<int>((60.0 / 120.0) * sampleRate);
+    // Chord length from the last published tempo and time signature
+    updateChordDuration();
+    
+    // Reserve room for a block's worth of chord changes and previews
+    midiBuffer.ensureSize(2048);
+    liveMidiInput.prepare(sampleRate);
+    midiOutput.prepare(sampleRate, samplesPerBlockExpected);
+    callbackMonitor.prepare(sampleRate, samplesPerBlockExpected);
 }
 
 void MainComponent::getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill)
 {
+    // Nothing below may allocate, lock or log
+    const AudioThreadGuard::Scope audioThread;
+    TRACE_SCOPE("MainComponent::getNextAudioBlock");
+    
+    const auto callbackStart = AudioCallbackMonitor::beginCallback();
+    const auto chordsStartedBefore = chordScheduler.getNumChordsStarted();
+    
     // Clear the buffer first
     bufferToFill.clearActiveBufferRegion();
     
-    // Handle MIDI playback timing
-    if (isPlaying && currentProgression.size() > 0)
+    // Pick up any tempo, time signature or loop changes from the UI
+    playbackSettings.read(audioSettings);
+    
+    // Collect notes from hover previews
+    midiBuffer.clear();
+    keyboardState.processNextMidiBuffer(midiBuffer, 0, bufferToFill.numSamples, true);
+    
+    // Add notes from MIDI controllers at their sample offsets
+    liveMidiInput.renderNextBlock(midiBuffer, bufferToFill.numSamples);
+    
+    // Pick up any progression changes made on the message thread
+    processPlaybackCommands();
+    
+    if (audioSettings.followMidiClock)
     {
-        auto numSamples = bufferToFill.numSamples;
-        
-        for (int sample = 0; sample < numSamples; ++sample)
+        // Chords change on the external clock's bar lines
+        renderSyncedChords(bufferToFill.numSamples);
+    }
+    else
+    {
+        // Update timing based on time signature and tempo when a chord starts in this block
+        if (chordScheduler.isActive() && chordScheduler.getSamplesUntilNextChord() < bufferToFill.numSamples)
         {
-            if (samplesUntilNextChord <= 0)
-            {
-                // Stop current chord
-                stopCurrentChord();
-                
-                // Play next chord if available
-                if (currentChordIndex < currentProgression.size())
-                {
-                    playChord(currentProgression[currentChordIndex]);
-                    currentChordIndex++;
-                    
-                    // Update timing based on time signature and tempo
-                    updateChordDuration();
-                    samplesUntilNextChord = samplesPerBeat;
-                }
-                else
-                {
-                    // End of progression
-                    if (shouldLoop)
-                    {
-                        // Loop back to the beginning
-                        currentChordIndex = 0;
-                        stopCurrentChord();
-                    }
-                    else
-                    {
-                        stopProgression();
-                    }
-                }
-            }
-            else
-            {
-                samplesUntilNextChord--;
-            }
+            updateChordDuration();
+            chordScheduler.setChordLengthSamples(samplesPerBeat);
         }
+        
+        // Write this block's chord changes at their exact sample offsets
+        chordScheduler.setLooping(audioSettings.loop);
+        if (chordScheduler.renderNextBlock(midiBuffer, bufferToFill.numSamples))
+            finishProgression();
     }
     
-    // Process MIDI keyboard input
-    juce::MidiBuffer incomingMidi;
-    keyboardState.processNextMidiBuffer(incomingMidi, 0, bufferToFill.numSamples, true);
+    // Silence whichever destination was just switched off
+    const auto mode = outputMode.load();
     
-    // Debug MIDI messages
-    if (!incomingMidi.isEmpty())
+    if (mode != lastOutputMode)
     {
-        DBG("MIDI messages received: " << incomingMidi.getNumEvents());
+        if (mode == OutputMode::MidiOut)
+            synth.allNotesOff(0, true);
+        
+        if (mode == OutputMode::Synth)
+            midiOutput.addAllNotesOff();
+        
+        lastOutputMode = mode;
     }
     
-    // Add any progression playback MIDI messages here if needed
+    // Send this block's events to the MIDI port, stamped from the audio clock
+    if (mode != OutputMode::Synth)
+        midiOutput.addBlock(midiBuffer, bufferToFill.numSamples);
     
     // Render synthesizer audio
-    synth.renderNextBlock(*bufferToFill.buffer, incomingMidi, 0, bufferToFill.numSamples);
+    synth.renderNextBlock(*bufferToFill.buffer, mode == OutputMode::MidiOut ? emptyMidiBuffer : midiBuffer,
+                          0, bufferToFill.numSamples);
     
-    // Check if we're generating any audio
-    auto magnitude = bufferToFill.buffer->getMagnitude(0, bufferToFill.numSamples);
-    if (magnitude > 0.001f)
-    {
-        DBG("Audio magnitude: " << magnitude);
-    }
+    callbackMonitor.endCallback(callbackStart, bufferToFill.numSamples, synth.getStatistics().activeVoices,
+                                (int) (chordScheduler.getNumChordsStarted() - chordsStartedBefore));
 }
 
 void MainComponent::releaseResources()
 {
     // This will be called when the audio device stops, or when it is being
     // restarted due to a setting change.
-    stopProgression();
+    if (isPlaying)
+        stopProgression();
+    
+    // Forget held controller notes; the synth is reset when the device restarts
+    midiBuffer.clear();
+    liveMidiInput.allNotesOff(midiBuffer, 0);
 }
 
 void MainComponent::paint(juce::Graphics& g)
 {
+    TRACE_SCOPE("MainComponent::paint");
+    
     const auto& colors = themeManager.getColors();
     g.fillAll(getLookAndFeel().findColour(juce::ResizableWindow::backgroundColourId));
     
@@ -468,6 +533,8 @@ void MainComponent::paint(juce::Graphics& g)
 
 void MainComponent::resized()
 {
+    TRACE_SCOPE("MainComponent::resized");
+    
     auto bounds = getLocalBounds();
     
     // Title bar area
@@ -496,6 +563,28 @@ void MainComponent::resized()
     tempoLabel.setBounds(topControlBar.removeFromLeft(90).reduced(5));
     tempoEditor.setBounds(topControlBar.removeFromLeft(60).reduced(5));
     
+    topControlBar.removeFromLeft(10);  // Spacing
+    
+    // MIDI controller chord mode
+    midiChordModeButton.setBounds(topControlBar.removeFromLeft(110).reduced(5));
+    
+    topControlBar.removeFromLeft(10);  // Spacing
+    
+    // Output routing
+    outputModeComboBox.setBounds(topControlBar.removeFromLeft(130).reduced(5));
+    midiOutputComboBox.setBounds(topControlBar.removeFromLeft(200).reduced(5));
+    
+    topControlBar.removeFromLeft(10);  // Spacing
+    
+    // Clock source
+    syncComboBox.setBounds(topControlBar.removeFromLeft(130).reduced(5));
+    
+    topControlBar.removeFromLeft(10);  // Spacing
+    
+    // Audio statistics overlay
+    statsButton.setBounds(topControlBar.removeFromLeft(70).reduced(5));
+    callbackMonitorOverlay.setBounds(getLocalBounds().removeFromBottom(120).removeFromRight(540).reduced(10));
+    
     // Add some spacing after top bar
     bounds.removeFromTop(10);
     
@@ -607,8 +696,14 @@ void MainComponent::resized()
     // Position play/stop, loop, and MIDI drag buttons aligned with badge buttons
     int playButtonY = badgeButtonArea.getY();
     playStopButton.setBounds(playControlArea.getX() + 10, playButtonY, playControlArea.getWidth() - 20, 25);
-    loopButton.setBounds(playControlArea.getX() + 10, playButtonY + 30, playControlArea.getWidth() - 20, 25);
+    int toggleWidth = (playControlArea.getWidth() - 20) / 2;
+    loopButton.setBounds(playControlArea.getX() + 10, playButtonY + 30, toggleWidth, 25);
+    voiceLeadingButton.setBounds(loopButton.getRight(), playButtonY + 30, toggleWidth, 25);
     midiDragButton.setBounds(playControlArea.getX() + 10, playButtonY + 60, playControlArea.getWidth() - 20, 25);
+    exportAudioButton.setBounds(playControlArea.getX() + 10, playButtonY + 90, playControlArea.getWidth() - 20, 25);
+    
+    // Chord played on a MIDI controller, under the badges
+    liveChordLabel.setBounds(progressionArea.reduced(20, 0).removeFromBottom(30));
     
     // Hide the keyboard (keep for MIDI functionality but don't display)
     keyboard.setBounds(0, 0, 0, 0);
@@ -621,22 +716,16 @@ void MainComponent::keySelectionChanged()
     updateDisplay();
     updateChordButtonLabels();  // Update button labels when key changes
     
-    // If currently playing, reload the progression with the new key
-    if (isPlaying)
-    {
-        playProgression();
-    }
+    // If currently playing, swap in the progression for the new key
+    refreshPlayingProgression();
 }
 
 void MainComponent::progressionSelectionChanged()
 {
     updateDisplay();
     
-    // If currently playing, reload the progression
-    if (isPlaying)
-    {
-        playProgression();
-    }
+    // If currently playing, swap in the updated progression
+    refreshPlayingProgression();
 }
 
 void MainComponent::updateDisplay()
@@ -681,21 +770,29 @@ void MainComponent::updateTimeSignature()
     }
 }
 
+double MainComponent::getTempo() const
+{
+    // Tempo field clamped to the supported range
+    return juce::jlimit(60.0, 200.0, (double) tempoEditor.getText().getIntValue());
+}
+
 void MainComponent::updateChordDuration()
 {
-    // Update samples per beat based on the beat unit
-    double currentTempo = tempoEditor.getText().getIntValue();
-    if (currentTempo < 60) currentTempo = 60;
-    if (currentTempo > 200) currentTempo = 200;
-    
-    // Calculate samples per beat (quarter note)
-    double quarterNoteDuration = 60.0 / currentTempo;
-    
-    // Adjust for beat unit (e.g., 8th notes are half a quarter note)
-    double beatDuration = quarterNoteDuration * (4.0 / beatUnit);
-    
-    // Each chord lasts for the full measure
-    samplesPerBeat = static_cast<int>(beatDuration * beatsPerMeasure * sampleRate);
+    // Audio thread: each chord lasts for the full measure
+    samplesPerBeat = ChordScheduler::getChordLengthSamples(audioSettings.tempo, audioSettings.beatsPerMeasure,
+                                                           audioSettings.beatUnit, sampleRate);
+}
+
+void MainComponent::publishPlaybackSettings()
+{
+    // Message thread: the audio thread picks these up at its next block
+    PlaybackSettings settings;
+    settings.tempo = getTempo();
+    settings.beatsPerMeasure = beatsPerMeasure;
+    settings.beatUnit = beatUnit;
+    settings.loop = loopButton.getToggleState();
+    settings.followMidiClock = syncComboBox.getSelectedId() == 2;
+    playbackSettings.write(settings);
 }
 
 
@@ -703,95 +800,134 @@ void MainComponent::updateChordDuration()
 //==============================================================================
 // MIDI Playback Methods
 
+ProgressionSnapshot MainComponent::buildProgressionSnapshot() const
+{
+    TRACE_SCOPE("MainComponent::buildProgressionSnapshot");
+    
+    bool useSevenths = chordTypeComboBox.getSelectedId() == 2;
+    
+    // Get selected voicing
+    KeyManager::Voicing voicing = KeyManager::Voicing::Close;
+    
+    // Build progression from scale degrees, with any applied emotions
+    auto progression = ProgressionExport::buildProgression(keyManager, emotionWheel, customProgressionDegrees,
+                                                           customProgressionEmotions, useSevenths, voicing);
+    
+    // Pick inversions across the whole progression so the voices move as little as possible
+    if (voiceLeadingButton.getToggleState())
+        return VoiceLeader::optimise(progression);
+    
+    return progression;
+}
+
 void MainComponent::playProgression()
 {
     // Play custom progression if it exists
     if (!customProgressionDegrees.empty())
     {
-        stopProgression(); // Stop any current playback
-        
-        bool useSevenths = chordTypeComboBox.getSelectedId() == 2;
-        
-        // Get selected voicing
-        KeyManager::Voicing voicing = KeyManager::Voicing::Close;
+        // The audio thread restarts from the first chord when it picks this up
+        PlaybackCommand command;
+        command.type = PlaybackCommand::Type::Play;
+        command.progression = buildProgressionSnapshot();
         
-        // Build progression from scale degrees
-        currentProgression.clear();
-        for (int i = 0; i < customProgressionDegrees.size(); ++i)
+        if (playbackCommands.push(command))
         {
-            int degree = customProgressionDegrees[i];
-            auto scaleDegree = static_cast<KeyManager::ScaleDegree>(degree);
-            
-            // Generate chord based on type
-            std::vector<int> chord;
-            
-            // Check if this chord has an emotion applied
-            if (i < customProgressionEmotions.size())
-            {
-                auto emotion = customProgressionEmotions[i];
-                
-                // Get the root note for this scale degree
-                auto scaleNotes = keyManager.getScaleNotes();
-                if (degree - 1 < scaleNotes.size())
-                {
-                    // Scale notes are 0-11 (pitch classes), so add base octave (60 = middle C)
-                    int rootNote = 60 + scaleNotes[degree - 1];
-                    
-                    // Apply emotion to get chord notes
-                    chord = emotionWheel.applyEmotion(rootNote, emotion);
-                }
-                else
-                {
-                    // Fallback to regular chord generation
-                    if (useSevenths)
-                        chord = keyManager.generateSeventh(scaleDegree);
-                    else
-                        chord = keyManager.generateTriad(scaleDegree);
-                }
-            }
-            else
-            {
-                // No emotion applied, use regular chord generation
-                if (useSevenths)
-                    chord = keyManager.generateSeventh(scaleDegree);
-                else
-                    chord = keyManager.generateTriad(scaleDegree);
-            }
-            
-            // Apply voicing
-            chord = keyManager.applyVoicing(chord, voicing);
-            
-            currentProgression.push_back(chord);
+            ++progressionsStarted;
+            isPlaying = true;
         }
-        
-        currentChordIndex = 0;
-        isPlaying = true;
-        
-        // Calculate initial timing based on time signature
-        updateChordDuration();
-        samplesUntilNextChord = 0; // Start immediately
     }
 }
 
+void MainComponent::refreshPlayingProgression()
+{
+    // Swap the edited progression in without restarting playback
+    if (!isPlaying || customProgressionDegrees.empty())
+        return;
+    
+    PlaybackCommand command;
+    command.type = PlaybackCommand::Type::Update;
+    command.progression = buildProgressionSnapshot();
+    playbackCommands.push(command);
+}
+
 void MainComponent::stopProgression()
 {
+    PlaybackCommand command;
+    command.type = PlaybackCommand::Type::Stop;
+    playbackCommands.push(command);
+    
     isPlaying = false;
-    currentChordIndex = 0;
-    currentProgression.clear();
-    stopCurrentChord();
+}
+
+void MainComponent::processPlaybackCommands()
+{
+    // Audio thread: apply queued commands at the start of the block
+    PlaybackCommand command;
     
-    // Update button text on the message thread (safe when called from audio thread)
-    // If called from message thread (e.g., onClick), this will queue but the onClick
-    // handler's synchronous update happens first, so no conflict
-    juce::MessageManager::callAsync([safeThis = juce::Component::SafePointer<MainComponent>(this)]() {
-        if (safeThis != nullptr && !safeThis->isPlaying)
-            safeThis->playStopButton.setButtonText("Play");
+    while (playbackCommands.pop(command))
+    {
+        switch (command.type)
+        {
+            case PlaybackCommand::Type::Play:
+                chordScheduler.stop(midiBuffer, 0);
+                
+                // Calculate initial timing based on time signature
+                updateChordDuration();
+                chordScheduler.setChordLengthSamples(samplesPerBeat);
+                chordScheduler.play(command.progression); // Starts immediately
+                ++audioProgressionsStarted;
+                break;
+                
+            case PlaybackCommand::Type::Update:
+                chordScheduler.update(command.progression);
+                break;
+                
+            case PlaybackCommand::Type::Stop:
+                chordScheduler.stop(midiBuffer, 0);
+                break;
+        }
+    }
+}
+
+void MainComponent::renderSyncedChords(int numSamples)
+{
+    // Audio thread: the progression repeats for as long as the clock runs
+    const auto position = liveMidiInput.getClockPosition(audioSettings.beatsPerMeasure, audioSettings.beatUnit);
+    
+    if (!position.isPlaying)
+    {
+        chordScheduler.pause(midiBuffer, 0);
+        return;
+    }
+    
+    TransportSync::forEachBar(position, numSamples, sampleRate, [this](juce::int64 bar, int sampleOffset) {
+        chordScheduler.playBar(midiBuffer, bar, sampleOffset);
     });
 }
 
-void MainComponent::playChord(const std::vector<int>& chord)
+void MainComponent::finishProgression()
+{
+    // Audio thread: the progression ran to the end without looping. The
+    // timer picks this up, so nothing here allocates or posts a message.
+    progressionsFinished.store(audioProgressionsStarted, std::memory_order_release);
+}
+
+void MainComponent::checkPlaybackFinished()
+{
+    // Only the progression started last counts; an older one may finish
+    // just after Play was pressed again
+    if (isPlaying && progressionsFinished.load(std::memory_order_acquire) == progressionsStarted)
+    {
+        isPlaying = false;
+        playStopButton.setButtonText("Play");
+    }
+}
+
+void MainComponent::playChord(const ChordNotes& chord)
 {
-    if (chord.empty()) return;
+    TRACE_SCOPE("MainComponent::playChord");
+    
+    if (chord.isEmpty()) return;
     
     // Stop current notes
     stopCurrentChord();
@@ -802,13 +938,98 @@ void MainComponent::playChord(const std::vector<int>& chord)
     // Play new chord notes using the keyboard state
     for (int note : chord)
     {
-        if (note >= 0 && note < 128)
+        // ChordNotes only holds valid MIDI note numbers
+        keyboardState.noteOn(1, note, 0.7f);
+        currentChordNotes.add(note);
+    }
+}
+
+void MainComponent::updateLiveChordMap()
+{
+    TRACE_SCOPE("MainComponent::updateLiveChordMap");
+    
+    // Each degree uses the emotion applied to its first chord in the
+    // progression, if any, so playing along sounds like the progression
+    bool useSevenths = chordTypeComboBox.getSelectedId() == 2;
+    const auto scaleNotes = keyManager.getScaleNotes();
+    
+    LiveChordMap map;
+    map.key = static_cast<int>(keyManager.getCurrentKey());
+    map.chordMode = midiChordModeButton.getToggleState();
+    
+    for (int degree = 1; degree <= LiveChordMap::numDegrees; ++degree)
+    {
+        std::vector<EmotionWheel::Emotion> emotions;
+        
+        for (size_t i = 0; i < customProgressionDegrees.size() && i < customProgressionEmotions.size(); ++i)
         {
-            // Note is already a proper MIDI note number
-            keyboardState.noteOn(1, note, 0.7f);
-            currentChordNotes.push_back(note);
+            if (customProgressionDegrees[i] == degree)
+            {
+                emotions.push_back(customProgressionEmotions[i]);
+                break;
+            }
         }
+        
+        auto chord = ProgressionExport::buildProgression(keyManager, emotionWheel, { degree }, emotions,
+                                                         useSevenths, KeyManager::Voicing::Close);
+        map.chords[(size_t) degree - 1] = chord[0];
+        map.roots[(size_t) degree - 1] = 60 + scaleNotes[(size_t) degree - 1];
+    }
+    
+    liveMidiInput.setChordMap(map);
+}
+
+void MainComponent::enableMidiInputs()
+{
+    TRACE_SCOPE("MainComponent::enableMidiInputs");
+    
+    // Open every connected controller; the settings dialog can turn them off
+    for (const auto& device : juce::MidiInput::getAvailableDevices())
+        if (!deviceManager.isMidiInputDeviceEnabled(device.identifier))
+            deviceManager.setMidiInputDeviceEnabled(device.identifier, true);
+    
+    // Runs on the device threads and feeds the audio callback directly
+    deviceManager.addMidiInputDeviceCallback({}, &liveMidiInput);
+}
+
+void MainComponent::refreshMidiOutputs()
+{
+    TRACE_SCOPE("MainComponent::refreshMidiOutputs");
+    
+    // Id 1 is a virtual port other apps can connect to; hardware outputs follow
+    midiOutputComboBox.clear(juce::dontSendNotification);
+   #if JUCE_LINUX || JUCE_BSD || JUCE_MAC
+    midiOutputComboBox.addItem(juce::String(MidiOutputSender::virtualPortName) + " (virtual)", 1);
+   #endif
+    
+    midiOutputDevices = juce::MidiOutput::getAvailableDevices();
+    
+    for (int i = 0; i < midiOutputDevices.size(); ++i)
+        midiOutputComboBox.addItem(midiOutputDevices[i].name, i + 2);
+}
+
+void MainComponent::midiOutputChanged()
+{
+    outputMode = static_cast<OutputMode>(outputModeComboBox.getSelectedId());
+    
+    const bool useMidiOut = outputMode != OutputMode::Synth;
+    midiOutputComboBox.setEnabled(useMidiOut);
+    
+    if (!useMidiOut)
+    {
+        midiOutput.closeDevice();
+        return;
     }
+    
+    // Default to the first port when MIDI out is switched on
+    if (midiOutputComboBox.getSelectedId() == 0 && midiOutputComboBox.getNumItems() > 0)
+        midiOutputComboBox.setSelectedItemIndex(0, juce::dontSendNotification);
+    
+    const int selectedId = midiOutputComboBox.getSelectedId();
+    const auto identifier = selectedId >= 2 ? midiOutputDevices[selectedId - 2].identifier : juce::String();
+    
+    if (selectedId == 0 || !midiOutput.openDevice(identifier))
+        DBG("Couldn't open MIDI output " << midiOutputComboBox.getText());
 }
 
 void MainComponent::stopCurrentChord()
@@ -822,6 +1043,8 @@ void MainComponent::stopCurrentChord()
 
 void MainComponent::mouseEnter(const juce::MouseEvent& event)
 {
+    TRACE_SCOPE("MainComponent::mouseEnter");
+    
     // Check if the mouse is over one of the chord buttons
     for (int i = 0; i < 7; ++i)
     {
@@ -831,15 +1054,8 @@ void MainComponent::mouseEnter(const juce::MouseEvent& event)
             auto scaleDegree = static_cast<KeyManager::ScaleDegree>(i + 1);
             bool useSevenths = chordTypeComboBox.getSelectedId() == 2;
             
-            std::vector<int> chord;
-            if (useSevenths)
-            {
-                chord = keyManager.generateSeventh(scaleDegree);
-            }
-            else
-            {
-                chord = keyManager.generateTriad(scaleDegree);
-            }
+            const auto& chord = useSevenths ? keyManager.getSeventh(scaleDegree)
+                                            : keyManager.getTriad(scaleDegree);
             
             playChord(chord);
             return;
@@ -861,47 +1077,16 @@ void MainComponent::mouseEnter(const juce::MouseEvent& event)
                 auto scaleDegree = static_cast<KeyManager::ScaleDegree>(degree);
                 bool useSevenths = chordTypeComboBox.getSelectedId() == 2;
                 
-                std::vector<int> baseChord;
-                if (useSevenths)
-                {
-                    baseChord = keyManager.generateSeventh(scaleDegree);
-                }
-                else
-                {
-                    baseChord = keyManager.generateTriad(scaleDegree);
-                }
+                const auto& baseChord = useSevenths ? keyManager.getSeventh(scaleDegree)
+                                                    : keyManager.getTriad(scaleDegree);
                 
-                // Get the tonality to find the right emotion
-                auto chordType = useSevenths ? keyManager.analyzeSeventh(scaleDegree) : keyManager.analyzeTriad(scaleDegree);
-                EmotionWheel::Tonality tonality = EmotionWheel::Tonality::Major;
-                
-                if (useSevenths)
-                {
-                    if (chordType == KeyManager::ChordType::Minor7 ||
-                        chordType == KeyManager::ChordType::Minor9 ||
-                        chordType == KeyManager::ChordType::HalfDiminished7 ||
-                        chordType == KeyManager::ChordType::Diminished7)
-                    {
-                        tonality = EmotionWheel::Tonality::Minor;
-                    }
-                }
-                else
-                {
-                    if (chordType == KeyManager::ChordType::Minor ||
-                        chordType == KeyManager::ChordType::Diminished)
-                    {
-                        tonality = EmotionWheel::Tonality::Minor;
-                    }
-                }
-                
-                // Get the emotion and apply it
-                auto emotions = emotionWheel.getEmotionsByTonality(tonality);
+                // Get the emotions for this chord's tonality
+                auto emotions = EmotionWheel::getEmotionsByTonality(getChordTonality(degree));
                 if (i < emotions.size())
                 {
                     auto emotion = emotions[i];
                     int rootNote = baseChord[0];
-                    std::vector<int> emotionChord = emotionWheel.applyEmotion(rootNote, emotion);
-                    playChord(emotionChord);
+                    playChord(emotionWheel.applyEmotion(rootNote, emotion));
                 }
             }
             return;
@@ -942,79 +1127,16 @@ void MainComponent::mouseDrag(const juce::MouseEvent& event)
         if (customProgressionDegrees.empty())
             return;
             
-        // Create a MIDI sequence from the current progression
-        juce::MidiFile midiFile;
-        midiFile.setTicksPerQuarterNote(960);
-        
-        juce::MidiMessageSequence track;
-        
-        // Get time signature
-        int beatsPerBar = 4;
-        switch (timeSignatureComboBox.getSelectedId())
-        {
-            case 1: beatsPerBar = 4; break;  // 4/4
-            case 2: beatsPerBar = 3; break;  // 3/4
-            case 3: beatsPerBar = 6; break;  // 6/8
-            case 4: beatsPerBar = 5; break;  // 5/4
-            default: beatsPerBar = 4; break;
-        }
-        
-        // Calculate ticks per chord based on time signature
-        int ticksPerChord = midiFile.getTimeFormat() * beatsPerBar;
-        
-        // Add each chord to the MIDI sequence
-        int currentTick = 0;
-        bool useSevenths = chordTypeComboBox.getSelectedId() == 2;
-        
-        for (size_t i = 0; i < customProgressionDegrees.size(); ++i)
-        {
-            int degree = customProgressionDegrees[i];
-            auto scaleDegree = static_cast<KeyManager::ScaleDegree>(degree);
-            
-            // Generate base chord
-            std::vector<int> chord;
-            if (useSevenths)
-            {
-                chord = keyManager.generateSeventh(scaleDegree);
-            }
-            else
-            {
-                chord = keyManager.generateTriad(scaleDegree);
-            }
-            
-            // Apply emotion if one exists for this chord
-            if (i < customProgressionEmotions.size())
-            {
-                auto emotion = customProgressionEmotions[i];
-                int rootNote = chord[0];
-                chord = emotionWheel.applyEmotion(rootNote, emotion);
-            }
-            
-            // Add MIDI notes for this chord
-            for (int note : chord)
-            {
-                if (note >= 0 && note < 128)
-                {
-                    track.addEvent(juce::MidiMessage::noteOn(1, note, 0.7f), currentTick);
-                    track.addEvent(juce::MidiMessage::noteOff(1, note), currentTick + ticksPerChord);
-                }
-            }
-            
-            currentTick += ticksPerChord;
-        }
-        
-        midiFile.addTrack(track);
+        // Create a MIDI file from the current progression, timed like playback
+        auto midiFile = ProgressionExport::createMidiFile(buildProgressionSnapshot(), getTempo(),
+                                                          beatsPerMeasure, beatUnit);
         
         // Write MIDI file to temporary location
         auto tempFile = juce::File::getSpecialLocation(juce::File::tempDirectory)
             .getChildFile("chord_progression.mid");
         
-        juce::FileOutputStream stream(tempFile);
-        if (stream.openedOk())
+        if (ProgressionExport::writeMidiFile(midiFile, tempFile))
         {
-            midiFile.writeTo(stream);
-            stream.flush();
-            
             // Create drag description with file
             juce::StringArray files;
             files.add(tempFile.getFullPathName());
@@ -1025,14 +1147,85 @@ void MainComponent::mouseDrag(const juce::MouseEvent& event)
     }
 }
 
+//==============================================================================
+// Audio Export Methods
+
+void MainComponent::exportAudio()
+{
+    if (customProgressionDegrees.empty() || exportThread != nullptr)
+        return;
+    
+    exportFileChooser = std::make_unique<juce::FileChooser>(
+        "Export progression as audio",
+        juce::File::getSpecialLocation(juce::File::userMusicDirectory).getChildFile("chord_progression.wav"),
+        "*.wav;*.flac");
+    
+    auto flags = juce::FileBrowserComponent::saveMode
+               | juce::FileBrowserComponent::canSelectFiles
+               | juce::FileBrowserComponent::warnAboutOverwriting;
+    
+    exportFileChooser->launchAsync(flags, [this](const juce::FileChooser& chooser) {
+        auto file = chooser.getResult();
+        
+        if (file != juce::File())
+            startExport(file.hasFileExtension("wav;flac") ? file : file.withFileExtension("wav"));
+    });
+}
+
+void MainComponent::startExport(const juce::File& file)
+{
+    // Render with the same timing as live playback, but as fast as the CPU allows
+    OfflineRenderer::Settings settings;
+    settings.tempo = getTempo();
+    settings.beatsPerMeasure = beatsPerMeasure;
+    settings.beatUnit = beatUnit;
+    settings.polyphony = synth.getPolyphony();
+    
+    if (sampleRate > 0.0)
+        settings.sampleRate = sampleRate;
+    
+    exportThread = std::make_unique<OfflineRenderThread>(
+        buildProgressionSnapshot(), settings, file,
+        [safeThis = juce::Component::SafePointer<MainComponent>(this)](juce::Result result) {
+            if (safeThis != nullptr)
+                safeThis->exportFinished(result);
+        });
+    
+    exportAudioButton.setEnabled(false);
+    exportThread->startThread();
+}
+
+void MainComponent::exportFinished(juce::Result result)
+{
+    exportThread.reset();
+    
+    exportAudioButton.setButtonText("Export Audio");
+    exportAudioButton.setEnabled(true);
+    
+    if (result.failed())
+        juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::WarningIcon,
+                                               "Export failed", result.getErrorMessage());
+}
+
+void MainComponent::timerCallback()
+{
+    checkPlaybackFinished();
+    
+    // Show the background export's progress on its button
+    if (exportThread != nullptr)
+        exportAudioButton.setButtonText("Exporting " + juce::String(juce::roundToInt(exportThread->getProgress() * 100.0f)) + "%");
+}
+
 void MainComponent::showAudioSettings()
 {
+    TRACE_SCOPE("MainComponent::showAudioSettings");
+    
     // Create and show audio device selector component
     auto audioSetupComp = std::make_unique<juce::AudioDeviceSelectorComponent>(
         deviceManager,
         0, 0,  // min/max input channels
         0, 256,  // min/max output channels
-        false, // show MIDI inputs
+        true,  // show MIDI inputs
         false, // show MIDI outputs
         false, // show channels as stereo pairs
         false  // hide advanced options
@@ -1056,6 +1249,8 @@ void MainComponent::showAudioSettings()
 
 void MainComponent::tryInitializeAudioDevice()
 {
+    TRACE_SCOPE("MainComponent::tryInitializeAudioDevice");
+    
     DBG("=== Initializing Default Audio Device ===");
     
     // Simply use the system default audio output device
@@ -1084,6 +1279,8 @@ void MainComponent::tryInitializeAudioDevice()
 
 void MainComponent::detectSystemAudioDevices()
 {
+    TRACE_SCOPE("MainComponent::detectSystemAudioDevices");
+    
     DBG("=== Available Audio Device Types ===");
     
     auto& audioDeviceTypes = deviceManager.getAvailableDeviceTypes();
@@ -1181,6 +1378,8 @@ void MainComponent::removeChordAtIndex(int index)
 
 void MainComponent::updateCustomProgressionDisplay()
 {
+    TRACE_SCOPE("MainComponent::updateCustomProgressionDisplay");
+    
     // Update badge buttons
     bool useSevenths = chordTypeComboBox.getSelectedId() == 2;
     const auto& colors = themeManager.getColors();
@@ -1220,6 +1419,9 @@ void MainComponent::updateCustomProgressionDisplay()
         }
     }
     
+    // Keep the controller chords in step with the key and applied emotions
+    updateLiveChordMap();
+    
     // Trigger layout update
     resized();
 }
@@ -1309,43 +1511,16 @@ void MainComponent::updateEmotionComboBox()
         return;
     }
     
-    // Determine if the selected chord is major or minor
-    int degree = customProgressionDegrees[selectedChordIndexForEmotion];
-    auto scaleDegree = static_cast<KeyManager::ScaleDegree>(degree);
-    bool useSevenths = chordTypeComboBox.getSelectedId() == 2;
-    auto chordType = useSevenths ? keyManager.analyzeSeventh(scaleDegree) : keyManager.analyzeTriad(scaleDegree);
-    
-    // Determine tonality based on chord type
-    EmotionWheel::Tonality tonality = EmotionWheel::Tonality::Major;
-    
-    if (useSevenths)
-    {
-        if (chordType == KeyManager::ChordType::Minor7 ||
-            chordType == KeyManager::ChordType::Minor9 ||
-            chordType == KeyManager::ChordType::HalfDiminished7 ||
-            chordType == KeyManager::ChordType::Diminished7)
-        {
-            tonality = EmotionWheel::Tonality::Minor;
-        }
-    }
-    else
-    {
-        if (chordType == KeyManager::ChordType::Minor ||
-            chordType == KeyManager::ChordType::Diminished)
-        {
-            tonality = EmotionWheel::Tonality::Minor;
-        }
-    }
-    
-    // Get emotions for this tonality and populate buttons
-    auto emotions = emotionWheel.getEmotionsByTonality(tonality);
+    // Emotions offered for the selected chord's tonality
+    auto emotions = EmotionWheel::getEmotionsByTonality(getChordTonality(customProgressionDegrees[selectedChordIndexForEmotion]));
     
     for (size_t i = 0; i < 24; ++i)
     {
         if (i < emotions.size())
         {
             auto emotion = emotions[i];
-            juce::String emotionName = EmotionWheel::getEmotionName(emotion);
+            auto name = EmotionWheel::getEmotionName(emotion);
+            juce::String emotionName = juce::String::fromUTF8(name.data(), (int) name.size());
             emotionButtons[i].setButtonText(emotionName);
             emotionButtons[i].setEnabled(true);
         }
@@ -1360,6 +1535,35 @@ void MainComponent::updateEmotionComboBox()
     emotionDescriptionLabel.setText("", juce::dontSendNotification);
 }
 
+EmotionWheel::Tonality MainComponent::getChordTonality(int degree) const
+{
+    // Minor and diminished chords take the minor emotions
+    auto scaleDegree = static_cast<KeyManager::ScaleDegree>(degree);
+    
+    if (chordTypeComboBox.getSelectedId() == 2)
+    {
+        switch (keyManager.analyzeSeventh(scaleDegree))
+        {
+            case KeyManager::ChordType::Minor7:
+            case KeyManager::ChordType::Minor9:
+            case KeyManager::ChordType::HalfDiminished7:
+            case KeyManager::ChordType::Diminished7:
+                return EmotionWheel::Tonality::Minor;
+            default:
+                return EmotionWheel::Tonality::Major;
+        }
+    }
+    
+    switch (keyManager.analyzeTriad(scaleDegree))
+    {
+        case KeyManager::ChordType::Minor:
+        case KeyManager::ChordType::Diminished:
+            return EmotionWheel::Tonality::Minor;
+        default:
+            return EmotionWheel::Tonality::Major;
+    }
+}
+
 void MainComponent::updateEmotionDescription()
 {
     if (selectedChordIndexForEmotion < 0 || selectedChordIndexForEmotion >= customProgressionDegrees.size())
@@ -1374,33 +1578,8 @@ void MainComponent::updateEmotionDescription()
         return;
     }
     
-    // Get the tonality to find the right emotion
-    int degree = customProgressionDegrees[selectedChordIndexForEmotion];
-    auto scaleDegree = static_cast<KeyManager::ScaleDegree>(degree);
-    bool useSevenths = chordTypeComboBox.getSelectedId() == 2;
-    auto chordType = useSevenths ? keyManager.analyzeSeventh(scaleDegree) : keyManager.analyzeTriad(scaleDegree);
-    
-    EmotionWheel::Tonality tonality = EmotionWheel::Tonality::Major;
-    if (useSevenths)
-    {
-        if (chordType == KeyManager::ChordType::Minor7 ||
-            chordType == KeyManager::ChordType::Minor9 ||
-            chordType == KeyManager::ChordType::HalfDiminished7 ||
-            chordType == KeyManager::ChordType::Diminished7)
-        {
-            tonality = EmotionWheel::Tonality::Minor;
-        }
-    }
-    else
-    {
-        if (chordType == KeyManager::ChordType::Minor ||
-            chordType == KeyManager::ChordType::Diminished)
-        {
-            tonality = EmotionWheel::Tonality::Minor;
-        }
-    }
-    
-    auto emotions = emotionWheel.getEmotionsByTonality(tonality);
+    // Emotions offered for the selected chord's tonality
+    auto emotions = EmotionWheel::getEmotionsByTonality(getChordTonality(customProgressionDegrees[selectedChordIndexForEmotion]));
     if (selectedEmotionIndex < emotions.size())
     {
         auto emotion = emotions[selectedEmotionIndex];
@@ -1408,7 +1587,8 @@ void MainComponent::updateEmotionDescription()
         
         if (profile)
         {
-            emotionDescriptionLabel.setText(juce::String(profile->description), juce::dontSendNotification);
+            emotionDescriptionLabel.setText(juce::String::fromUTF8(profile->description.data(), (int) profile->description.size()),
+                                            juce::dontSendNotification);
         }
     }
 }
@@ -1421,33 +1601,8 @@ void MainComponent::applyEmotionToChord()
     if (selectedEmotionIndex < 0)
         return;
     
-    // Get the selected emotion
-    int degree = customProgressionDegrees[selectedChordIndexForEmotion];
-    auto scaleDegree = static_cast<KeyManager::ScaleDegree>(degree);
-    bool useSevenths = chordTypeComboBox.getSelectedId() == 2;
-    auto chordType = useSevenths ? keyManager.analyzeSeventh(scaleDegree) : keyManager.analyzeTriad(scaleDegree);
-    
-    EmotionWheel::Tonality tonality = EmotionWheel::Tonality::Major;
-    if (useSevenths)
-    {
-        if (chordType == KeyManager::ChordType::Minor7 ||
-            chordType == KeyManager::ChordType::Minor9 ||
-            chordType == KeyManager::ChordType::HalfDiminished7 ||
-            chordType == KeyManager::ChordType::Diminished7)
-        {
-            tonality = EmotionWheel::Tonality::Minor;
-        }
-    }
-    else
-    {
-        if (chordType == KeyManager::ChordType::Minor ||
-            chordType == KeyManager::ChordType::Diminished)
-        {
-            tonality = EmotionWheel::Tonality::Minor;
-        }
-    }
-    
-    auto emotions = emotionWheel.getEmotionsByTonality(tonality);
+    // Emotions offered for the selected chord's tonality
+    auto emotions = EmotionWheel::getEmotionsByTonality(getChordTonality(customProgressionDegrees[selectedChordIndexForEmotion]));
     if (selectedEmotionIndex >= emotions.size())
         return;
     
@@ -1465,10 +1620,7 @@ void MainComponent::applyEmotionToChord()
     // Update display to show the change
     updateCustomProgressionDisplay();
     
-    // If currently playing, restart with the new emotion applied
-    if (isPlaying)
-    {
-        playProgression();
-    }
+    // If currently playing, swap in the progression with the new emotion applied
+    refreshPlayingProgression();
 }
 
@@ -4,6 +4,20 @@
 #include "KeyManager.h"
 #include "ThemeManager.h"  // Temporarily disabled
 #include "EmotionWheel.h"
+#include "PlaybackCommands.h"
+#include "AudioThreadGuard.h"
+#include "AudioCallbackMonitorOverlay.h"
+#include "Tracing.h"
+#include "ChordScheduler.h"
+#include "ChordSynthesiser.h"
+#include "OfflineRenderer.h"
+#include "ProgressionExport.h"
+#include "ChordTable.h"
+#include "VoiceLeader.h"
+#include "LiveMidiInput.h"
+#include "LiveChordLabel.h"
+#include "MidiOutputSender.h"
+#include "TransportSync.h"
 
 //==============================================================================
 // Custom LookAndFeel for circular button
@@ -93,150 +107,6 @@ private:
     CircularButtonLookAndFeel circularLookAndFeel;
 };
 
-//==============================================================================
-// Forward declaration
-class SineWaveSound;
-
-//==============================================================================
-// Waveform types
-enum class WaveformType
-{
-    Sine,
-    Sawtooth,
-    Square,
-    Triangle
-};
-
-//==============================================================================
-// Synthesizer Voice with Multiple Waveforms
-class SineWaveVoice : public juce::SynthesiserVoice
-{
-public:
-    SineWaveVoice() : waveformType(WaveformType::Sine) {}
-    
-    void setWaveform(WaveformType type) { waveformType = type; }
-    
-    bool canPlaySound(juce::SynthesiserSound* sound) override
-    {
-        return true; // Accept any sound for simplicity
-    }
-    
-    void startNote(int midiNoteNumber, float velocity, juce::SynthesiserSound*, int) override
-    {
-        frequency = juce::MidiMessage::getMidiNoteInHertz(midiNoteNumber);
-        level = velocity * 0.15;
-        tailOff = 0.0;
-        
-        auto cyclesPerSample = frequency / getSampleRate();
-        angleDelta = cyclesPerSample * 2.0 * juce::MathConstants<double>::pi;
-    }
-    
-    void stopNote(float, bool allowTailOff) override
-    {
-        if (allowTailOff)
-        {
-            if (tailOff == 0.0)
-                tailOff = 1.0;
-        }
-        else
-        {
-            clearCurrentNote();
-            angleDelta = 0.0;
-        }
-    }
-    
-    void pitchWheelMoved(int) override {}
-    void controllerMoved(int, int) override {}
-    
-    void renderNextBlock(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples) override
-    {
-        if (angleDelta != 0.0)
-        {
-            if (tailOff > 0.0)
-            {
-                while (--numSamples >= 0)
-                {
-                    auto currentSample = (float)(generateWaveform(currentAngle) * level * tailOff);
-                    
-                    for (auto i = outputBuffer.getNumChannels(); --i >= 0;)
-                        outputBuffer.addSample(i, startSample, currentSample);
-                    
-                    currentAngle += angleDelta;
-                    ++startSample;
-                    
-                    tailOff *= 0.99;
-                    
-                    if (tailOff <= 0.005)
-                    {
-                        clearCurrentNote();
-                        angleDelta = 0.0;
-                        break;
-                    }
-                }
-            }
-            else
-            {
-                while (--numSamples >= 0)
-                {
-                    auto currentSample = (float)(generateWaveform(currentAngle) * level);
-                    
-                    for (auto i = outputBuffer.getNumChannels(); --i >= 0;)
-                        outputBuffer.addSample(i, startSample, currentSample);
-                    
-                    currentAngle += angleDelta;
-                    ++startSample;
-                }
-            }
-        }
-    }
-
-private:
-    double generateWaveform(double angle)
-    {
-        // Normalize angle to 0-2π range
-        double normalizedAngle = std::fmod(angle, 2.0 * juce::MathConstants<double>::pi);
-        if (normalizedAngle < 0)
-            normalizedAngle += 2.0 * juce::MathConstants<double>::pi;
-        
-        switch (waveformType)
-        {
-            case WaveformType::Sine:
-                return std::sin(angle);
-                
-            case WaveformType::Sawtooth:
-                // Sawtooth: ramp from -1 to 1
-                return 2.0 * (normalizedAngle / (2.0 * juce::MathConstants<double>::pi)) - 1.0;
-                
-            case WaveformType::Square:
-                // Square: -1 or 1 based on angle
-                return (std::sin(angle) >= 0.0) ? 1.0 : -1.0;
-                
-            case WaveformType::Triangle:
-                // Triangle: folded sawtooth
-                {
-                    double t = normalizedAngle / (2.0 * juce::MathConstants<double>::pi);
-                    return 4.0 * std::abs(t - 0.5) - 1.0;
-                }
-                
-            default:
-                return std::sin(angle);
-        }
-    }
-    
-    WaveformType waveformType;
-    double currentAngle = 0.0, angleDelta = 0.0, level = 0.0, tailOff = 0.0;
-    double frequency = 0.0;
-};
-
-//==============================================================================
-// Simple Synthesizer Sound
-class SineWaveSound : public juce::SynthesiserSound
-{
-public:
-    bool appliesToNote(int) override { return true; }
-    bool appliesToChannel(int) override { return true; }
-};
-
 //==============================================================================
 // Enums for musical concepts
 enum class KeySignature
@@ -272,7 +142,8 @@ enum class ScaleType
     This component lives inside our window, and this is where you should put all
     your controls and content.
 */
-class MainComponent  : public juce::AudioAppComponent
+class MainComponent  : public juce::AudioAppComponent,
+                       private juce::Timer
 {
 public:
     //==============================================================================
@@ -310,11 +181,19 @@ private:
     juce::ComboBox progressionsDropdown;  // Dummy dropdown for progressions
     juce::ComboBox chordTypeComboBox;
     juce::ComboBox timeSignatureComboBox;
+    juce::ComboBox outputModeComboBox;  // Synth, MIDI out or both
+    juce::ComboBox midiOutputComboBox;  // Virtual port or a hardware output
+    juce::ComboBox syncComboBox;  // Internal tempo or incoming MIDI clock
+    juce::ToggleButton statsButton;  // Shows callbackMonitorOverlay
+    juce::Array<juce::MidiDeviceInfo> midiOutputDevices;  // Items in midiOutputComboBox from id 2
     juce::TextButton playStopButton;  // Combined play/stop button
     juce::ToggleButton loopButton;
+    juce::ToggleButton voiceLeadingButton;  // Revoices the progression for smooth voice leading
+    juce::ToggleButton midiChordModeButton;  // One-finger chords from MIDI controllers
     juce::Label tempoEditor;  // Text field for tempo entry
     juce::TextButton audioSettingsButton;
     juce::TextButton midiDragButton;  // Button to drag MIDI progression to DAW
+    juce::TextButton exportAudioButton;  // Bounces the progression to a WAV/FLAC file
     
     // Emotion Wheel components
     std::array<juce::TextButton, 24> emotionButtons;  // Grid of emotion buttons
@@ -342,27 +221,51 @@ private:
     CircularButtonLookAndFeel circularButtonLookAndFeel;
     
     // MIDI and Audio Components
-    juce::Synthesiser synth;
+    ChordSynthesiser synth;
     juce::MidiKeyboardState keyboardState;
     juce::MidiKeyboardComponent keyboard;
     
     // Playback state
-    bool isPlaying;
-    bool shouldLoop;
-    int currentChordIndex;
+    std::atomic<bool> isPlaying { false };       // Message thread's view of playback
+    int progressionsStarted = 0;                 // Message thread: Play commands sent
+    int audioProgressionsStarted = 0;            // Audio thread: Play commands applied
+    std::atomic<int> progressionsFinished { 0 }; // Audio -> message thread: last one to run to the end
     juce::int64 nextChordTime;
     juce::int64 chordDuration;
     double sampleRate;
     int samplesPerBeat;
-    int samplesUntilNextChord;
     int beatsPerMeasure;
     int beatUnit;
-    std::vector<std::vector<int>> currentProgression;
+    PlaybackCommandQueue playbackCommands;  // Message thread -> audio thread
+    PlaybackSettingsBuffer playbackSettings;  // Message thread -> audio thread
+    PlaybackSettings audioSettings;         // Audio thread's copy
+    ChordScheduler chordScheduler;          // Audio thread only
+    juce::MidiBuffer midiBuffer;            // Audio thread only
+    LiveMidiInput liveMidiInput;            // MIDI devices -> audio thread
+    LiveChordLabel liveChordLabel { liveMidiInput, keyManager };
+    MidiOutputSender midiOutput;            // Audio thread -> MIDI output port
+    AudioCallbackMonitor callbackMonitor;   // Audio thread -> UI
+    AudioCallbackMonitorOverlay callbackMonitorOverlay { callbackMonitor, synth, deviceManager };
+    juce::MidiBuffer emptyMidiBuffer;       // Fed to the synth when it is muted
+    
+    // Where playback goes; read by the audio thread every block
+    enum class OutputMode
+    {
+        Synth = 1,
+        MidiOut,
+        Both
+    };
+    std::atomic<OutputMode> outputMode { OutputMode::Synth };
+    OutputMode lastOutputMode = OutputMode::Synth;  // Audio thread only
     juce::OwnedArray<ButtonWithBadge> chordButtonsWithBadges;
-    std::vector<int> currentChordNotes;
+    ChordNotes currentChordNotes;  // Hover preview notes currently held
     std::vector<int> customProgressionDegrees;  // Stores the scale degrees (1-7) for custom progression
     std::vector<EmotionWheel::Emotion> customProgressionEmotions;  // Stores applied emotions (parallel to customProgressionDegrees)
     int selectedChordIndexForEmotion = -1;  // Track which chord is selected for emotion editing
+    
+    // Audio export
+    std::unique_ptr<juce::FileChooser> exportFileChooser;
+    std::unique_ptr<OfflineRenderThread> exportThread;
 
     
     //==============================================================================
@@ -372,6 +275,8 @@ private:
     void updateDisplay();
     void updateTimeSignature();
     void updateChordDuration();
+    void publishPlaybackSettings();
+    double getTempo() const;
     
     // Chord progression builder functions
     void addChordToProgression(int scaleDegree);
@@ -388,16 +293,33 @@ private:
     void applyEmotionToChord();
     void updateEmotionDescription();
     void selectChordForEmotionWheel(int chordIndex);
+    EmotionWheel::Tonality getChordTonality(int degree) const;
 
     
     // MIDI Playback functions
+    ProgressionSnapshot buildProgressionSnapshot() const;
     void playProgression();
+    void refreshPlayingProgression();
     void stopProgression();
-    void playChord(const std::vector<int>& chord);
+    void processPlaybackCommands();
+    void renderSyncedChords(int numSamples);
+    void finishProgression();
+    void playChord(const ChordNotes& chord);
     void stopCurrentChord();
+    void updateLiveChordMap();
+    void enableMidiInputs();
+    void refreshMidiOutputs();
+    void midiOutputChanged();
     void showAudioSettings();
     void tryInitializeAudioDevice();
     void detectSystemAudioDevices();
+    
+    // Audio export functions
+    void exportAudio();
+    void startExport(const juce::File& file);
+    void exportFinished(juce::Result result);
+    void timerCallback() override;
+    void checkPlaybackFinished();
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MainComponent)
 };
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "LockFreeFifo.h"
+
+//==============================================================================
+// Sends the audio callback's MIDI to a hardware or virtual output port.
+// The audio thread only stamps each event with the time it will be heard,
+// taken from a running sample count, and queues it. A sender thread, running
+// only while a port is open, hands the events to
+// juce::MidiOutput::sendBlockOfMessages, whose own thread delivers them on
+// time. Events are stamped one block ahead, so a late UI
+// or sender thread doesn't move them as long as it catches up within a
+// block.
+class MidiOutputSender : private juce::Thread
+{
+public:
+    static constexpr const char* virtualPortName = "Chord Builder";
+
+    MidiOutputSender() : juce::Thread("MIDI Out") {}
+
+    ~MidiOutputSender() override
+    {
+        closeDevice();
+    }
+
+    //==============================================================================
+    // Message thread. An empty identifier creates a virtual port other apps can
+    // connect to (ALSA sequencer / CoreMIDI only).
+    bool openDevice(const juce::String& identifier)
+    {
+       #if JUCE_LINUX || JUCE_BSD || JUCE_MAC
+        auto device = identifier.isEmpty() ? juce::MidiOutput::createNewDevice(virtualPortName)
+                                           : juce::MidiOutput::openDevice(identifier);
+       #else
+        auto device = juce::MidiOutput::openDevice(identifier);
+       #endif
+
+        if (device != nullptr)
+            device->startBackgroundThread();
+
+        closeDevice();
+
+        if (device == nullptr)
+            return false;
+
+        // Anything queued while no port was open is stale
+        for (Event event; events.pop(event);)
+            ;
+
+        {
+            const juce::ScopedLock lock(outputLock);
+            output = std::move(device);
+        }
+
+        startThread();
+        return true;
+    }
+
+    // Message thread: silences anything still sounding on the port and closes it
+    void closeDevice()
+    {
+        stopThread(1000);
+        std::unique_ptr<juce::MidiOutput> oldOutput;
+
+        {
+            const juce::ScopedLock lock(outputLock);
+            oldOutput = std::move(output);
+        }
+
+        if (oldOutput != nullptr)
+        {
+            oldOutput->clearAllPendingMessages();
+
+            for (int channel = 1; channel <= 16; ++channel)
+                oldOutput->sendMessageNow(juce::MidiMessage::allNotesOff(channel));
+        }
+    }
+
+    juce::String getDeviceName() const
+    {
+        const juce::ScopedLock lock(outputLock);
+        return output != nullptr ? output->getName() : juce::String();
+    }
+
+    //==============================================================================
+    // Call from prepareToPlay
+    void prepare(double newSampleRate, int samplesPerBlock) noexcept
+    {
+        sampleRate = newSampleRate;
+        latencyMs = 1000.0 * samplesPerBlock / sampleRate;
+        needsAnchor = true;
+    }
+
+    // Audio thread: queues a block's events, timed from the audio clock
+    void addBlock(const juce::MidiBuffer& midi, int numSamples) noexcept
+    {
+        const auto blockStart = getBlockStartTime(numSamples);
+
+        for (const auto metadata : midi)
+            if (metadata.numBytes <= 3)
+                pushEvent(metadata.data, metadata.numBytes, blockStart + 1000.0 * metadata.samplePosition / sampleRate);
+    }
+
+    // Audio thread: releases every note on the port, e.g. when MIDI out is switched off
+    void addAllNotesOff() noexcept
+    {
+        // Never ahead of notes already queued, or they would start after it
+        const auto time = juce::jmax(juce::Time::getMillisecondCounterHiRes() + latencyMs, lastEventMs);
+
+        for (int channel = 1; channel <= 16; ++channel)
+        {
+            const auto message = juce::MidiMessage::allNotesOff(channel);
+            pushEvent(message.getRawData(), message.getRawDataSize(), time);
+        }
+    }
+
+private:
+    struct Event
+    {
+        juce::uint8 data[3] {};
+        int numBytes = 0;
+        double timeMs = 0.0;  // Time::getMillisecondCounterHiRes() when it should sound
+    };
+
+    void pushEvent(const juce::uint8* data, int numBytes, double timeMs) noexcept
+    {
+        Event event;
+        std::copy(data, data + numBytes, event.data);
+        event.numBytes = numBytes;
+        event.timeMs = timeMs;
+        events.push(event);
+        lastEventMs = timeMs;
+    }
+
+    // The sample count drives the timing. It is re-anchored to the system
+    // clock after a gap or xrun and nudged towards it otherwise, so the two
+    // clocks can't drift apart.
+    double getBlockStartTime(int numSamples) noexcept
+    {
+        const auto now = juce::Time::getMillisecondCounterHiRes();
+        auto predicted = anchorMs + 1000.0 * (samplePosition - anchorSample) / sampleRate;
+
+        if (needsAnchor || std::abs(now - predicted) > 2.0 * latencyMs)
+        {
+            anchorMs = predicted = now;
+            anchorSample = samplePosition;
+            needsAnchor = false;
+        }
+        else
+        {
+            anchorMs += (now - predicted) * 0.01;
+        }
+
+        samplePosition += numSamples;
+        return predicted + latencyMs;
+    }
+
+    void run() override
+    {
+        juce::MidiBuffer block;
+        block.ensureSize(3 * 1024);
+        Event event;
+
+        while (!threadShouldExit())
+        {
+            block.clear();
+            double startMs = 0.0;
+
+            while (events.pop(event))
+            {
+                if (block.isEmpty())
+                    startMs = event.timeMs;
+
+                // Positions in microseconds from the first event
+                block.addEvent(event.data, event.numBytes, juce::roundToInt((event.timeMs - startMs) * 1000.0));
+            }
+
+            if (!block.isEmpty())
+            {
+                const juce::ScopedLock lock(outputLock);
+
+                if (output != nullptr)
+                    output->sendBlockOfMessages(block, startMs, 1000000.0);
+            }
+
+            wait(1);
+        }
+    }
+
+    // Audio thread -> sender thread
+    LockFreeFifo<Event, 1024> events;
+
+    // Sender and message threads
+    juce::CriticalSection outputLock;
+    std::unique_ptr<juce::MidiOutput> output;
+
+    // Audio thread only
+    double sampleRate = 44100.0;
+    double latencyMs = 0.0;
+    double anchorMs = 0.0;
+    double lastEventMs = 0.0;
+    juce::int64 anchorSample = 0;
+    juce::int64 samplePosition = 0;
+    bool needsAnchor = true;
+
+    JUCE_DECLARE_NON_COPYABLE(MidiOutputSender)
+};
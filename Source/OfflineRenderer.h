@@ -0,0 +1,188 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+#include "ChordScheduler.h"
+#include "ChordSynthesiser.h"
+
+//==============================================================================
+// Renders a progression through the same scheduler and synth the app plays
+// live, but with no audio device: blocks are produced as fast as the CPU
+// allows and streamed into a buffer or a WAV/FLAC file.
+class OfflineRenderer
+{
+public:
+    struct Settings
+    {
+        double sampleRate = 44100.0;
+        int numChannels = 2;
+        int bitsPerSample = 24;
+        int blockSize = 512;
+        double tempo = 120.0;
+        int beatsPerMeasure = 4;
+        int beatUnit = 4;
+        double tailSeconds = 0.5;  // Silence after the last chord for the release to ring out
+        int polyphony = ChordSynthesiser::defaultPolyphony;
+        WaveformType waveform = WaveformType::Sine;
+    };
+
+    // Number of samples the whole render will produce
+    static juce::int64 getLengthInSamples(const ProgressionSnapshot& progression, const Settings& settings)
+    {
+        auto chordLength = ChordScheduler::getChordLengthSamples(settings.tempo, settings.beatsPerMeasure,
+                                                                 settings.beatUnit, settings.sampleRate);
+        return (juce::int64) chordLength * progression.size()
+             + (juce::int64) (settings.tailSeconds * settings.sampleRate);
+    }
+
+    // Renders into output, which is resized to fit
+    static void renderToBuffer(const ProgressionSnapshot& progression, const Settings& settings,
+                               juce::AudioBuffer<float>& output, std::atomic<float>* progress = nullptr)
+    {
+        output.setSize(settings.numChannels, (int) getLengthInSamples(progression, settings));
+
+        render(progression, settings, progress, {},
+               [&output](const juce::AudioBuffer<float>& block, juce::int64 position, int numSamples)
+               {
+                   for (int channel = 0; channel < output.getNumChannels(); ++channel)
+                       output.copyFrom(channel, (int) position, block, channel, 0, numSamples);
+
+                   return true;
+               });
+    }
+
+    // Renders into a WAV or FLAC file, chosen by the file's extension.
+    // shouldAbort is polled between blocks so a background render can be cancelled.
+    // The audio goes to a temporary file next to the target, which only
+    // replaces it once the render has finished, so an existing file survives
+    // a cancelled or failed render.
+    static juce::Result renderToFile(const ProgressionSnapshot& progression, const Settings& settings,
+                                     const juce::File& file, std::atomic<float>* progress = nullptr,
+                                     const std::function<bool()>& shouldAbort = {})
+    {
+        std::unique_ptr<juce::AudioFormat> format;
+
+        if (file.hasFileExtension("flac"))
+            format = std::make_unique<juce::FlacAudioFormat>();
+        else
+            format = std::make_unique<juce::WavAudioFormat>();
+
+        juce::TemporaryFile temp(file);
+        std::unique_ptr<juce::OutputStream> stream = std::make_unique<juce::FileOutputStream>(temp.getFile());
+
+        if (!static_cast<juce::FileOutputStream&>(*stream).openedOk())
+            return juce::Result::fail("Couldn't open " + temp.getFile().getFullPathName() + " for writing");
+
+        auto options = juce::AudioFormatWriterOptions{}.withSampleRate(settings.sampleRate)
+                                                       .withNumChannels(settings.numChannels)
+                                                       .withBitsPerSample(settings.bitsPerSample);
+
+        auto writer = format->createWriterFor(stream, options);
+
+        if (writer == nullptr)
+            return juce::Result::fail("The " + format->getFormatName() + " writer doesn't support these settings");
+
+        auto completed = render(progression, settings, progress, shouldAbort,
+                                [&writer](const juce::AudioBuffer<float>& block, juce::int64, int numSamples)
+                                {
+                                    return writer->writeFromAudioSampleBuffer(block, 0, numSamples);
+                                });
+
+        writer.reset();
+
+        // The temporary file deletes itself when it goes out of scope
+        if (!completed)
+            return juce::Result::fail("Render of " + file.getFileName() + " was cancelled or failed to write");
+
+        if (!temp.overwriteTargetFileWithTemporary())
+            return juce::Result::fail("Couldn't replace " + file.getFullPathName());
+
+        return juce::Result::ok();
+    }
+
+private:
+    using BlockWriter = std::function<bool(const juce::AudioBuffer<float>&, juce::int64, int)>;
+
+    static bool render(const ProgressionSnapshot& progression, const Settings& settings,
+                       std::atomic<float>* progress, const std::function<bool()>& shouldAbort,
+                       const BlockWriter& writeBlock)
+    {
+        ChordSynthesiser synth;
+        synth.prepare(settings.sampleRate, settings.blockSize);
+        synth.setPolyphony(settings.polyphony);
+        synth.setWaveform(settings.waveform);
+
+        ChordScheduler scheduler;
+        scheduler.setChordLengthSamples(ChordScheduler::getChordLengthSamples(settings.tempo, settings.beatsPerMeasure,
+                                                                              settings.beatUnit, settings.sampleRate));
+        scheduler.play(progression);
+
+        juce::AudioBuffer<float> block(settings.numChannels, settings.blockSize);
+        juce::MidiBuffer midi;
+        const auto totalSamples = getLengthInSamples(progression, settings);
+
+        for (juce::int64 position = 0; position < totalSamples; position += settings.blockSize)
+        {
+            if (shouldAbort && shouldAbort())
+                return false;
+
+            auto numSamples = (int) juce::jmin((juce::int64) settings.blockSize, totalSamples - position);
+
+            block.clear();
+            midi.clear();
+            scheduler.renderNextBlock(midi, numSamples);
+            synth.renderNextBlock(block, midi, 0, numSamples);
+
+            if (!writeBlock(block, position, numSamples))
+                return false;
+
+            if (progress != nullptr)
+                *progress = (float) (position + numSamples) / (float) totalSamples;
+        }
+
+        return true;
+    }
+};
+
+//==============================================================================
+// Runs an OfflineRenderer file render on a background thread.
+// Progress can be polled from the UI; onComplete is called on the message
+// thread when the file is written, fails or is cancelled.
+class OfflineRenderThread : public juce::Thread
+{
+public:
+    OfflineRenderThread(const ProgressionSnapshot& progressionToRender, const OfflineRenderer::Settings& renderSettings,
+                        const juce::File& file, std::function<void(juce::Result)> completionCallback)
+        : juce::Thread("Offline render"),
+          progression(progressionToRender),
+          settings(renderSettings),
+          outputFile(file),
+          onComplete(std::move(completionCallback))
+    {
+    }
+
+    ~OfflineRenderThread() override
+    {
+        stopThread(5000);
+    }
+
+    float getProgress() const noexcept { return progress; }
+
+    void run() override
+    {
+        auto result = OfflineRenderer::renderToFile(progression, settings, outputFile, &progress,
+                                                    [this] { return threadShouldExit(); });
+
+        if (onComplete != nullptr)
+            juce::MessageManager::callAsync([callback = onComplete, result] { callback(result); });
+    }
+
+private:
+    ProgressionSnapshot progression;
+    OfflineRenderer::Settings settings;
+    juce::File outputFile;
+    std::function<void(juce::Result)> onComplete;
+    std::atomic<float> progress { 0.0f };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OfflineRenderThread)
+};
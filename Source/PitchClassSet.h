@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+
+//==============================================================================
+// A set of pitch classes (C, C#, ... B) packed into the low 12 bits of an int.
+// Notes are taken modulo 12, so MIDI note numbers and semitone intervals can
+// be passed in directly. Membership, transposition and comparing a chord with
+// a scale are each a couple of bit operations, and everything is constexpr.
+class PitchClassSet
+{
+public:
+    static constexpr int numPitchClasses = 12;
+    static constexpr uint16_t allBits = (1u << numPitchClasses) - 1;
+
+    constexpr PitchClassSet() noexcept = default;
+
+    constexpr PitchClassSet(std::initializer_list<int> notes) noexcept
+    {
+        for (int note : notes)
+            bits |= bitFor(note);
+    }
+
+    static constexpr PitchClassSet fromBits(unsigned int mask) noexcept
+    {
+        PitchClassSet set;
+        set.bits = (uint16_t) (mask & allBits);
+        return set;
+    }
+
+    // Any range of note numbers or intervals (vector, ChordNotes, ...)
+    template <typename Range>
+    static constexpr PitchClassSet fromNotes(const Range& notes) noexcept
+    {
+        PitchClassSet set;
+
+        for (int note : notes)
+            set.bits |= bitFor(note);
+
+        return set;
+    }
+
+    constexpr uint16_t getBits() const noexcept          { return bits; }
+    constexpr bool isEmpty() const noexcept              { return bits == 0; }
+    constexpr bool contains(int note) const noexcept     { return (bits & bitFor(note)) != 0; }
+
+    constexpr PitchClassSet with(int note) const noexcept     { return fromBits(bits | bitFor(note)); }
+    constexpr PitchClassSet without(int note) const noexcept  { return fromBits(bits & ~bitFor(note)); }
+
+    // Number of pitch classes in the set
+    constexpr int size() const noexcept
+    {
+        int count = 0;
+
+        for (unsigned int b = bits; b != 0; b &= b - 1)
+            ++count;
+
+        return count;
+    }
+
+    // Rotates every pitch class up by the given number of semitones
+    constexpr PitchClassSet transposed(int semitones) const noexcept
+    {
+        const int shift = wrap(semitones);
+        return fromBits(((unsigned int) bits << shift) | ((unsigned int) bits >> (numPitchClasses - shift)));
+    }
+
+    constexpr PitchClassSet intersectedWith(PitchClassSet other) const noexcept  { return fromBits(bits & other.bits); }
+    constexpr PitchClassSet unitedWith(PitchClassSet other) const noexcept      { return fromBits(bits | other.bits); }
+    constexpr PitchClassSet complement() const noexcept                         { return fromBits(~(unsigned int) bits); }
+
+    constexpr bool isSubsetOf(PitchClassSet other) const noexcept  { return (bits & ~other.bits) == 0; }
+
+    // Number of pitch classes that differ between the two sets
+    constexpr int distanceTo(PitchClassSet other) const noexcept   { return fromBits(bits ^ other.bits).size(); }
+
+    // How many members lie below the given pitch class, e.g. its scale step
+    // in a scale rotated to start on C; -1 if it isn't in the set
+    constexpr int indexOf(int note) const noexcept
+    {
+        if (!contains(note))
+            return -1;
+
+        return fromBits(bits & (bitFor(note) - 1u)).size();
+    }
+
+    // Lowest pitch class in the set, or -1 if empty
+    constexpr int getLowest() const noexcept
+    {
+        for (int pc = 0; pc < numPitchClasses; ++pc)
+            if (contains(pc))
+                return pc;
+
+        return -1;
+    }
+
+    constexpr bool operator==(PitchClassSet other) const noexcept  { return bits == other.bits; }
+    constexpr bool operator!=(PitchClassSet other) const noexcept  { return bits != other.bits; }
+
+    //==============================================================================
+    // Iterates the pitch classes in ascending order
+    class Iterator
+    {
+    public:
+        constexpr explicit Iterator(unsigned int remainingBits) noexcept : remaining(remainingBits) {}
+
+        constexpr int operator*() const noexcept
+        {
+            int pc = 0;
+
+            while ((remaining & (1u << pc)) == 0)
+                ++pc;
+
+            return pc;
+        }
+
+        constexpr Iterator& operator++() noexcept
+        {
+            remaining &= remaining - 1;
+            return *this;
+        }
+
+        constexpr bool operator!=(const Iterator& other) const noexcept { return remaining != other.remaining; }
+
+    private:
+        unsigned int remaining;
+    };
+
+    constexpr Iterator begin() const noexcept  { return Iterator(bits); }
+    constexpr Iterator end() const noexcept    { return Iterator(0); }
+
+private:
+    static constexpr int wrap(int note) noexcept
+    {
+        const int pc = note % numPitchClasses;
+        return pc < 0 ? pc + numPitchClasses : pc;
+    }
+
+    static constexpr unsigned int bitFor(int note) noexcept  { return 1u << wrap(note); }
+
+    uint16_t bits = 0;
+};
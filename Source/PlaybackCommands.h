@@ -0,0 +1,62 @@
+#pragma once
+
+#include "ChordNotes.h"
+#include "LockFreeFifo.h"
+#include "TripleBuffer.h"
+
+//==============================================================================
+// Immutable copy of a progression, built on the message thread and handed to
+// the audio thread by value through the command queue.
+struct ProgressionSnapshot
+{
+    static constexpr int maxChords = 8;
+
+    bool addChord(const ChordNotes& chord) noexcept
+    {
+        if (numChords >= maxChords)
+            return false;
+
+        chords[(size_t) numChords++] = chord;
+        return true;
+    }
+
+    int size() const noexcept                               { return numChords; }
+    bool isEmpty() const noexcept                           { return numChords == 0; }
+    const ChordNotes& operator[](int index) const noexcept  { return chords[(size_t) index]; }
+
+private:
+    std::array<ChordNotes, maxChords> chords {};
+    int numChords = 0;
+};
+
+//==============================================================================
+// Requests sent from the UI to the audio callback
+struct PlaybackCommand
+{
+    enum class Type
+    {
+        Play,   // Start the progression from the first chord
+        Update, // Swap in new chords but keep the current position
+        Stop    // Stop playback and release any sounding notes
+    };
+
+    Type type = Type::Stop;
+    ProgressionSnapshot progression;
+};
+
+using PlaybackCommandQueue = LockFreeFifo<PlaybackCommand, 32>;
+
+//==============================================================================
+// Timing settings from the UI, published whole whenever one of them changes
+// so the audio thread only ever reads plain numbers. Chord type and voicing
+// aren't here: they are already baked into each ProgressionSnapshot.
+struct PlaybackSettings
+{
+    double tempo = 120.0;
+    int beatsPerMeasure = 4;
+    int beatUnit = 4;
+    bool loop = false;
+    bool followMidiClock = false;  // Chords follow incoming MIDI clock instead of the tempo
+};
+
+using PlaybackSettingsBuffer = TripleBuffer<PlaybackSettings>;
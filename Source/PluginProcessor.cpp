@@ -0,0 +1,258 @@
+#include "PluginProcessor.h"
+
+namespace
+{
+    // One degree and one emotion parameter per chord of the custom progression
+    juce::String getDegreeID(int slot)   { return "degree" + juce::String(slot + 1); }
+    juce::String getEmotionID(int slot)  { return "emotion" + juce::String(slot + 1); }
+
+    juce::StringArray getParameterIDs()
+    {
+        juce::StringArray ids { "key", "progression", "chordType", "voicing", "voiceLeading" };
+
+        for (int slot = 0; slot < ProgressionSnapshot::maxChords; ++slot)
+        {
+            ids.add(getDegreeID(slot));
+            ids.add(getEmotionID(slot));
+        }
+
+        return ids;
+    }
+}
+
+//==============================================================================
+ChordBuilderProcessor::ChordBuilderProcessor()
+    : AudioProcessor(JucePlugin_IsMidiEffect ? BusesProperties()
+                                             : BusesProperties().withOutput("Output", juce::AudioChannelSet::stereo(), true)),
+      parameters(*this, nullptr, "ChordBuilder", createParameterLayout())
+{
+    for (const auto& id : getParameterIDs())
+        parameters.addParameterListener(id, this);
+
+    rebuildProgression();
+    startTimerHz(20);
+}
+
+ChordBuilderProcessor::~ChordBuilderProcessor()
+{
+    stopTimer();
+
+    for (const auto& id : getParameterIDs())
+        parameters.removeParameterListener(id, this);
+}
+
+juce::AudioProcessorValueTreeState::ParameterLayout ChordBuilderProcessor::createParameterLayout()
+{
+    KeyManager keyManager;
+    juce::StringArray keyNames, progressionNames { "Custom" };
+
+    for (int i = 0; i < 12; ++i)
+        keyNames.add(keyManager.getKeyName(static_cast<KeyManager::Key>(i)));
+
+    for (const auto& name : keyManager.getAvailableProgressions())
+        progressionNames.add(name);
+
+    juce::AudioProcessorValueTreeState::ParameterLayout layout;
+    layout.add(std::make_unique<juce::AudioParameterChoice>(juce::ParameterID { "key", 1 }, "Key", keyNames, 0));
+    layout.add(std::make_unique<juce::AudioParameterChoice>(juce::ParameterID { "progression", 1 }, "Progression",
+                                                            progressionNames, 0));
+    layout.add(std::make_unique<juce::AudioParameterChoice>(juce::ParameterID { "chordType", 1 }, "Chord Type",
+                                                            juce::StringArray { "Triads", "Sevenths" }, 0));
+    layout.add(std::make_unique<juce::AudioParameterChoice>(juce::ParameterID { "voicing", 1 }, "Voicing",
+                                                            ProgressionExport::getVoicingNames(), 0));
+    layout.add(std::make_unique<juce::AudioParameterBool>(juce::ParameterID { "voiceLeading", 1 }, "Smooth Voice Leading",
+                                                          false));
+
+    // The custom progression, played when the preset is "Custom". The
+    // emotions also apply to the chords of a preset.
+    const juce::StringArray degreeNames { "Off", "I", "II", "III", "IV", "V", "VI", "VII" };
+    const std::array<int, 4> defaultDegrees { 1, 5, 6, 4 };
+    juce::StringArray emotionNames { "None" };
+
+    for (int i = 0; i < EmotionWheel::numEmotions; ++i)
+    {
+        auto name = EmotionWheel::getEmotionName(static_cast<EmotionWheel::Emotion>(i));
+        emotionNames.add(juce::String::fromUTF8(name.data(), (int) name.size()));
+    }
+
+    for (int slot = 0; slot < ProgressionSnapshot::maxChords; ++slot)
+    {
+        const auto number = juce::String(slot + 1);
+        const int defaultDegree = slot < (int) defaultDegrees.size() ? defaultDegrees[(size_t) slot] : 0;
+
+        layout.add(std::make_unique<juce::AudioProcessorParameterGroup>(
+            "chord" + number, "Chord " + number, "|",
+            std::make_unique<juce::AudioParameterChoice>(juce::ParameterID { getDegreeID(slot), 1 }, "Chord " + number + " Degree",
+                                                         degreeNames, defaultDegree),
+            std::make_unique<juce::AudioParameterChoice>(juce::ParameterID { getEmotionID(slot), 1 }, "Chord " + number + " Emotion",
+                                                         emotionNames, 0)));
+    }
+
+    return layout;
+}
+
+//==============================================================================
+void ChordBuilderProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
+{
+   #if ! JucePlugin_IsMidiEffect
+    synth.prepare(sampleRate, samplesPerBlock);
+   #else
+    juce::ignoreUnused(sampleRate, samplesPerBlock);
+   #endif
+}
+
+void ChordBuilderProcessor::releaseResources()
+{
+}
+
+bool ChordBuilderProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
+{
+   #if JucePlugin_IsMidiEffect
+    juce::ignoreUnused(layouts);
+    return true;
+   #else
+    const auto& output = layouts.getMainOutputChannelSet();
+    return output == juce::AudioChannelSet::mono() || output == juce::AudioChannelSet::stereo();
+   #endif
+}
+
+void ChordBuilderProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi)
+{
+    juce::ScopedNoDenormals noDenormals;
+    const AudioThreadGuard::Scope audioThread;
+    const int numSamples = buffer.getNumSamples();
+
+    // Pick up edits made on the message thread; the new chord is struck at once
+    PlaybackCommand command;
+
+    while (progressionUpdates.pop(command))
+    {
+        chordScheduler.stop(midi, 0);
+        chordScheduler.play(command.progression);
+    }
+
+    // One chord per bar of the host's song, only while its transport runs
+    auto* playHead = getPlayHead();
+    const auto position = TransportSync::fromPlayHead(playHead != nullptr ? playHead->getPosition()
+                                                                          : juce::Optional<juce::AudioPlayHead::PositionInfo>());
+
+    if (position.isPlaying)
+    {
+        TransportSync::forEachBar(position, numSamples, getSampleRate(), [this, &midi](juce::int64 bar, int sampleOffset) {
+            chordScheduler.playBar(midi, bar, sampleOffset);
+        });
+    }
+    else
+    {
+        chordScheduler.pause(midi, 0);
+    }
+
+   #if ! JucePlugin_IsMidiEffect
+    buffer.clear();
+    synth.renderNextBlock(buffer, midi, 0, numSamples);
+   #endif
+}
+
+//==============================================================================
+void ChordBuilderProcessor::parameterChanged(const juce::String&, float)
+{
+    // Hosts may automate from any thread, so the rebuild happens on the timer
+    needsRebuild = true;
+}
+
+void ChordBuilderProcessor::timerCallback()
+{
+    if (needsRebuild.exchange(false))
+        rebuildProgression();
+}
+
+void ChordBuilderProcessor::rebuildProgression()
+{
+    const auto key = static_cast<KeyManager::Key>((int) parameters.getRawParameterValue("key")->load());
+    const int preset = (int) parameters.getRawParameterValue("progression")->load();
+    const bool useSevenths = parameters.getRawParameterValue("chordType")->load() > 0.5f;
+    const auto voicing = static_cast<KeyManager::Voicing>((int) parameters.getRawParameterValue("voicing")->load());
+    const bool useVoiceLeading = parameters.getRawParameterValue("voiceLeading")->load() > 0.5f;
+
+    keyManager.setCurrentKey(key);
+
+    // Each chord is a scale degree and the slot whose emotion it takes.
+    // Preset 0 is the custom progression, which skips slots set to "Off".
+    std::vector<std::pair<int, int>> chords;
+    const auto presets = keyManager.getAvailableProgressions();
+
+    if (preset > 0 && preset <= (int) presets.size())
+    {
+        const auto degrees = ProgressionExport::parseDegrees(presets[(size_t) preset - 1]);
+
+        for (size_t i = 0; i < degrees.size(); ++i)
+            chords.emplace_back(degrees[i], (int) i);
+    }
+    else
+    {
+        for (int slot = 0; slot < ProgressionSnapshot::maxChords; ++slot)
+        {
+            const int degree = (int) parameters.getRawParameterValue(getDegreeID(slot))->load();
+
+            if (degree > 0)
+                chords.emplace_back(degree, slot);
+        }
+    }
+
+    PlaybackCommand command;
+    command.type = PlaybackCommand::Type::Update;
+
+    for (const auto& [degree, slot] : chords)
+    {
+        if (slot >= ProgressionSnapshot::maxChords)
+            break;
+
+        // Emotion choice 0 is "None"
+        const int emotionIndex = (int) parameters.getRawParameterValue(getEmotionID(slot))->load() - 1;
+        const auto emotion = static_cast<EmotionWheel::Emotion>(emotionIndex);
+
+        command.progression.addChord(ProgressionExport::buildChord(keyManager, emotionWheel, degree,
+                                                                   emotionIndex >= 0 ? &emotion : nullptr,
+                                                                   useSevenths, voicing));
+    }
+
+    if (useVoiceLeading)
+        command.progression = VoiceLeader::optimise(command.progression);
+
+    progressionUpdates.push(command);
+}
+
+//==============================================================================
+juce::AudioProcessorEditor* ChordBuilderProcessor::createEditor()
+{
+    return new juce::GenericAudioProcessorEditor(*this);
+}
+
+void ChordBuilderProcessor::getStateInformation(juce::MemoryBlock& destData)
+{
+    if (auto xml = parameters.copyState().createXml())
+        copyXmlToBinary(*xml, destData);
+}
+
+void ChordBuilderProcessor::setStateInformation(const void* data, int sizeInBytes)
+{
+    auto xml = getXmlFromBinary(data, sizeInBytes);
+
+    if (xml == nullptr || !xml->hasTagName(parameters.state.getType()))
+        return;
+
+    parameters.replaceState(juce::ValueTree::fromXml(*xml));
+
+    // Some hosts restore sessions off the message thread
+    if (juce::MessageManager::existsAndIsCurrentThread())
+        rebuildProgression();
+    else
+        needsRebuild = true;
+}
+
+//==============================================================================
+// This creates new instances of the plugin
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+{
+    return new ChordBuilderProcessor();
+}
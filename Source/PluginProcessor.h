@@ -0,0 +1,86 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "KeyManager.h"
+#include "EmotionWheel.h"
+#include "PlaybackCommands.h"
+#include "AudioThreadGuard.h"
+#include "ChordScheduler.h"
+#include "TransportSync.h"
+#include "ProgressionExport.h"
+#include "VoiceLeader.h"
+#include "ChordSynthesiser.h"
+
+//==============================================================================
+// The progression engine as a plugin, for running inside a host instead of as
+// a separate app with its own audio device.
+// Built twice from the same source: ChordBuilderMidiFX.jucer makes a
+// zero-latency MIDI effect that writes the chords into the host's MIDI
+// stream, and ChordBuilderInstrument.jucer also plays them (and any incoming
+// MIDI) on the built-in synth. Chords follow the host: one per bar, from
+// its tempo, time signature and transport position.
+class ChordBuilderProcessor : public juce::AudioProcessor,
+                              private juce::AudioProcessorValueTreeState::Listener,
+                              private juce::Timer
+{
+public:
+    //==============================================================================
+    ChordBuilderProcessor();
+    ~ChordBuilderProcessor() override;
+
+    //==============================================================================
+    void prepareToPlay(double sampleRate, int samplesPerBlock) override;
+    void releaseResources() override;
+    bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
+    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi) override;
+    using AudioProcessor::processBlock;
+
+    //==============================================================================
+    juce::AudioProcessorEditor* createEditor() override;
+    bool hasEditor() const override  { return true; }
+
+    //==============================================================================
+    const juce::String getName() const override  { return JucePlugin_Name; }
+    bool acceptsMidi() const override            { return true; }
+    bool producesMidi() const override           { return true; }
+    bool isMidiEffect() const override           { return JucePlugin_IsMidiEffect != 0; }
+    double getTailLengthSeconds() const override { return 0.0; }
+
+    //==============================================================================
+    int getNumPrograms() override                               { return 1; }
+    int getCurrentProgram() override                            { return 0; }
+    void setCurrentProgram(int) override                        {}
+    const juce::String getProgramName(int) override             { return {}; }
+    void changeProgramName(int, const juce::String&) override   {}
+
+    //==============================================================================
+    void getStateInformation(juce::MemoryBlock& destData) override;
+    void setStateInformation(const void* data, int sizeInBytes) override;
+
+    juce::AudioProcessorValueTreeState parameters;
+
+private:
+    //==============================================================================
+    static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+
+    // Message thread
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+    void timerCallback() override;
+    void rebuildProgression();
+
+    // Message thread only
+    KeyManager keyManager;
+    EmotionWheel emotionWheel;
+    std::atomic<bool> needsRebuild { false };
+
+    // Message thread -> audio thread
+    PlaybackCommandQueue progressionUpdates;
+
+    // Audio thread only
+    ChordScheduler chordScheduler;
+   #if ! JucePlugin_IsMidiEffect
+    ChordSynthesiser synth;
+   #endif
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ChordBuilderProcessor)
+};
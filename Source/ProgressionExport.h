@@ -0,0 +1,126 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "KeyManager.h"
+#include "EmotionWheel.h"
+#include "PlaybackCommands.h"
+
+//==============================================================================
+// Turns scale degrees into concrete chords and MIDI files.
+// Shared by the UI (playback, MIDI drag) and the headless batch generator so
+// every path voices and times a progression the same way.
+class ProgressionExport
+{
+public:
+    static constexpr int ticksPerQuarterNote = 960;
+
+    // "I-V-vi-IV" -> { 1, 5, 6, 4 }; empty if any numeral is invalid
+    static std::vector<int> parseDegrees(const juce::String& name)
+    {
+        static const juce::StringArray numerals { "I", "II", "III", "IV", "V", "VI", "VII" };
+        std::vector<int> degrees;
+
+        for (const auto& token : juce::StringArray::fromTokens(name, "-", ""))
+        {
+            auto index = numerals.indexOf(token.trim(), true);
+
+            if (index < 0)
+                return {};
+
+            degrees.push_back(index + 1);
+        }
+
+        return degrees;
+    }
+
+    // In KeyManager::Voicing order
+    static juce::StringArray getVoicingNames()
+    {
+        return { "Close", "Open", "Drop2", "Drop3", "RootPosition", "FirstInversion", "SecondInversion", "Spread" };
+    }
+
+    // Builds the chords for a list of scale degrees (1-7). emotions runs
+    // parallel to degrees and may be shorter: chords past its end use the
+    // plain triad or seventh.
+    static ProgressionSnapshot buildProgression(const KeyManager& keyManager, const EmotionWheel& emotionWheel,
+                                                const std::vector<int>& degrees,
+                                                const std::vector<EmotionWheel::Emotion>& emotions,
+                                                bool useSevenths, KeyManager::Voicing voicing)
+    {
+        ProgressionSnapshot snapshot;
+
+        for (size_t i = 0; i < degrees.size(); ++i)
+            snapshot.addChord(buildChord(keyManager, emotionWheel, degrees[i], i < emotions.size() ? &emotions[i] : nullptr,
+                                         useSevenths, voicing));
+
+        return snapshot;
+    }
+
+    // One chord for a scale degree (1-7), voiced from the emotion when there
+    // is one and from the plain triad or seventh otherwise
+    static ChordNotes buildChord(const KeyManager& keyManager, const EmotionWheel& emotionWheel, int degree,
+                                 const EmotionWheel::Emotion* emotion, bool useSevenths, KeyManager::Voicing voicing)
+    {
+        if (emotion != nullptr)
+        {
+            const auto scaleNotes = keyManager.getScaleNotes();
+
+            if (degree >= 1 && degree <= (int) scaleNotes.size())
+            {
+                // Scale notes are 0-11 (pitch classes), so add base octave (60 = middle C)
+                auto chord = emotionWheel.applyEmotion(60 + scaleNotes[(size_t) degree - 1], *emotion);
+                return ChordNotes(keyManager.applyVoicing(chord.toVector(), voicing));
+            }
+        }
+
+        // Plain chords come straight from the precomputed table
+        auto scaleDegree = static_cast<KeyManager::ScaleDegree>(degree);
+        return useSevenths ? keyManager.getSeventh(scaleDegree, voicing)
+                           : keyManager.getTriad(scaleDegree, voicing);
+    }
+
+    // One chord per measure, with tempo and time signature meta events so a
+    // DAW picks the timing up on import
+    static juce::MidiFile createMidiFile(const ProgressionSnapshot& progression, double tempo,
+                                         int beatsPerMeasure, int beatUnit)
+    {
+        juce::MidiFile midiFile;
+        midiFile.setTicksPerQuarterNote(ticksPerQuarterNote);
+
+        juce::MidiMessageSequence track;
+        track.addEvent(juce::MidiMessage::tempoMetaEvent(juce::roundToInt(60000000.0 / tempo)), 0);
+        track.addEvent(juce::MidiMessage::timeSignatureMetaEvent(beatsPerMeasure, beatUnit), 0);
+
+        // The tick resolution counts quarter notes, so scale for other beat units
+        const int ticksPerChord = ticksPerQuarterNote * beatsPerMeasure * 4 / beatUnit;
+        int currentTick = 0;
+
+        for (int i = 0; i < progression.size(); ++i)
+        {
+            for (int note : progression[i])
+            {
+                track.addEvent(juce::MidiMessage::noteOn(1, note, 0.7f), currentTick);
+                track.addEvent(juce::MidiMessage::noteOff(1, note), currentTick + ticksPerChord);
+            }
+
+            currentTick += ticksPerChord;
+        }
+
+        track.updateMatchedPairs();
+        midiFile.addTrack(track);
+        return midiFile;
+    }
+
+    static bool writeMidiFile(const juce::MidiFile& midiFile, const juce::File& file)
+    {
+        file.deleteFile();
+        juce::FileOutputStream stream(file);
+
+        if (!stream.openedOk())
+            return false;
+
+        midiFile.writeTo(stream);
+        stream.flush();
+        return stream.getStatus().wasOk();
+    }
+};
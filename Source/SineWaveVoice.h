@@ -0,0 +1,268 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include "VoiceEnvelope.h"
+
+//==============================================================================
+// Waveform types
+enum class WaveformType
+{
+    Sine,
+    Sawtooth,
+    Square,
+    Triangle
+};
+
+//==============================================================================
+// One cycle of a sine wave, read with linear interpolation.
+// Shared by every voice and built once on first use.
+class SineTable
+{
+public:
+    static constexpr int size = 4096;
+
+    SineTable()
+    {
+        for (int i = 0; i <= size; ++i)
+            values[(size_t) i] = (float) std::sin(2.0 * juce::MathConstants<double>::pi * i / size);
+    }
+
+    // phase is a cycle position in [0, 1)
+    float lookup(double phase) const noexcept
+    {
+        auto position = phase * size;
+        auto index = (int) position;
+        auto fraction = (float) (position - index);
+        auto a = values[(size_t) index];
+        return a + fraction * (values[(size_t) index + 1] - a);
+    }
+
+    static const SineTable& getInstance()
+    {
+        static const SineTable table;
+        return table;
+    }
+
+private:
+    std::array<float, size + 1> values {}; // Extra guard point so index + 1 never wraps
+};
+
+//==============================================================================
+// Synthesizer Voice with Multiple Waveforms
+// Renders a whole block at a time: the waveform is chosen once per block, a
+// tight per-waveform kernel fills a per-voice scratch buffer, and the result
+// is mixed into each output channel with a single addFrom.
+// Sawtooth, square and triangle are band-limited with PolyBLEP corrections so
+// they stay clean at 44.1/48 kHz without oversampling.
+// The oscillator phase is a cycle position kept in [0, 1) and wrapped with a
+// subtract, so it never loses precision however long a note is held.
+// Amplitude follows a VoiceEnvelope; the voice frees itself the moment its
+// release finishes, even part way through a block.
+class SineWaveVoice : public juce::SynthesiserVoice
+{
+public:
+    SineWaveVoice() : waveformType(WaveformType::Sine), sineTable(SineTable::getInstance())
+    {
+        prepare(defaultBlockSize);
+    }
+
+    void setWaveform(WaveformType type) { waveformType = type; }
+    void setEnvelopeParameters(const VoiceEnvelope::Parameters& parameters) { envelope.setParameters(parameters); }
+
+    // Sizes the scratch buffer; call from prepareToPlay, never from the audio thread.
+    // Larger blocks still work, they are just rendered in several chunks.
+    void prepare(int maximumBlockSize)
+    {
+        scratchBuffer.setSize(1, juce::jmax(1, maximumBlockSize));
+    }
+
+    void setCurrentPlaybackSampleRate(double newRate) override
+    {
+        juce::SynthesiserVoice::setCurrentPlaybackSampleRate(newRate);
+        envelope.prepare(newRate);
+    }
+
+    bool canPlaySound(juce::SynthesiserSound* sound) override
+    {
+        return true; // Accept any sound for simplicity
+    }
+
+    void startNote(int midiNoteNumber, float velocity, juce::SynthesiserSound*, int) override
+    {
+        frequency = juce::MidiMessage::getMidiNoteInHertz(midiNoteNumber);
+        level = velocity * 0.15;
+
+        phaseDelta = frequency / getSampleRate();
+        envelope.noteOn();
+    }
+
+    void stopNote(float, bool allowTailOff) override
+    {
+        if (allowTailOff)
+            envelope.noteOff();
+        else
+            envelope.reset();
+
+        // With no release to play the voice can go back to the pool right away
+        if (!envelope.isActive())
+            freeVoice();
+    }
+
+    void pitchWheelMoved(int) override {}
+    void controllerMoved(int, int) override {}
+
+    void renderNextBlock(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples) override
+    {
+        auto* scratch = scratchBuffer.getWritePointer(0);
+
+        while (phaseDelta != 0.0 && numSamples > 0)
+        {
+            auto numThisTime = juce::jmin(numSamples, scratchBuffer.getNumSamples());
+
+            renderWaveform(scratch, numThisTime);
+
+            // The release may finish part way through the chunk
+            auto numToMix = envelope.process(scratch, numThisTime);
+
+            for (auto channel = outputBuffer.getNumChannels(); --channel >= 0;)
+                outputBuffer.addFrom(channel, startSample, scratch, numToMix);
+
+            if (!envelope.isActive())
+                freeVoice();
+
+            startSample += numThisTime;
+            numSamples -= numThisTime;
+        }
+    }
+
+private:
+    static constexpr int defaultBlockSize = 4096;
+
+    // Fills dest with numSamples of the current waveform, scaled by level,
+    // and advances the phase
+    void renderWaveform(float* dest, int numSamples) noexcept
+    {
+        const auto dt = phaseDelta;
+        auto t = phase;
+
+        switch (waveformType)
+        {
+            case WaveformType::Sawtooth:
+                // Sawtooth: ramp from -1 to 1, with the reset band-limited
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    dest[i] = (float) ((2.0 * t - 1.0 - polyBlep(t, dt)) * level);
+                    t = advance(t, dt);
+                }
+                break;
+
+            case WaveformType::Square:
+                // Square: -1 or 1 based on which half of the cycle we're in,
+                // with both edges band-limited
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    auto halfCycle = t < 0.5 ? t + 0.5 : t - 0.5;
+                    auto value = (t < 0.5 ? 1.0 : -1.0) + polyBlep(t, dt) - polyBlep(halfCycle, dt);
+                    dest[i] = (float) (value * level);
+                    t = advance(t, dt);
+                }
+                break;
+
+            case WaveformType::Triangle:
+                // Triangle: folded sawtooth, with the corners band-limited
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    auto halfCycle = t < 0.5 ? t + 0.5 : t - 0.5;
+                    auto value = 4.0 * std::abs(t - 0.5) - 1.0
+                               + 4.0 * dt * (polyBlamp(halfCycle, dt) - polyBlamp(t, dt));
+                    dest[i] = (float) (value * level);
+                    t = advance(t, dt);
+                }
+                break;
+
+            case WaveformType::Sine:
+            default:
+            {
+                const auto gain = (float) level;
+
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    dest[i] = sineTable.lookup(t) * gain;
+                    t = advance(t, dt);
+                }
+                break;
+            }
+        }
+
+        phase = t;
+    }
+
+    // Steps a cycle position on by one sample, keeping it in [0, 1)
+    static double advance(double t, double dt) noexcept
+    {
+        t += dt;
+        return t >= 1.0 ? t - 1.0 : t;
+    }
+
+    // PolyBLEP residual for a step of height 2 at phase 0, as a function of the
+    // cycle position t and the phase increment per sample dt. Subtracting it
+    // smooths the discontinuity over the two samples around it, which removes
+    // most of the aliasing of the naive waveform for a few extra multiplies.
+    static double polyBlep(double t, double dt) noexcept
+    {
+        if (t < dt)
+        {
+            t /= dt;
+            return t + t - t * t - 1.0;
+        }
+
+        if (t > 1.0 - dt)
+        {
+            t = (t - 1.0) / dt;
+            return t * t + t + t + 1.0;
+        }
+
+        return 0.0;
+    }
+
+    void freeVoice()
+    {
+        clearCurrentNote();
+        phaseDelta = 0.0;
+    }
+
+    // Integrated PolyBLEP, used for the slope changes (corners) of the triangle
+    static double polyBlamp(double t, double dt) noexcept
+    {
+        if (t < dt)
+        {
+            t = t / dt - 1.0;
+            return -1.0 / 3.0 * t * t * t;
+        }
+
+        if (t > 1.0 - dt)
+        {
+            t = (t - 1.0) / dt + 1.0;
+            return 1.0 / 3.0 * t * t * t;
+        }
+
+        return 0.0;
+    }
+
+    WaveformType waveformType;
+    const SineTable& sineTable;
+    VoiceEnvelope envelope;
+    juce::AudioBuffer<float> scratchBuffer;
+    double phase = 0.0, phaseDelta = 0.0, level = 0.0;
+    double frequency = 0.0;
+};
+
+//==============================================================================
+// Simple Synthesizer Sound
+class SineWaveSound : public juce::SynthesiserSound
+{
+public:
+    bool appliesToNote(int) override { return true; }
+    bool appliesToChannel(int) override { return true; }
+};
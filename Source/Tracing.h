@@ -0,0 +1,229 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "AudioThreadGuard.h"
+#include "LockFreeFifo.h"
+#include <cstring>
+
+// Set to 1 in the exporter's preprocessor definitions to build with tracing.
+// Without it TRACE_SCOPE compiles to nothing.
+#ifndef CHORD_BUILDER_ENABLE_TRACING
+ #define CHORD_BUILDER_ENABLE_TRACING 0
+#endif
+
+#if CHORD_BUILDER_ENABLE_TRACING
+
+//==============================================================================
+// Records how long marked zones of code take, on any thread, and writes them
+// to a Chrome trace file (open it in chrome://tracing or ui.perfetto.dev).
+// Each thread gets its own preallocated LockFreeFifo of events, so a zone
+// costs two clock reads and a push, even on the audio thread. A background
+// thread drains the queues into the file ten times a second. Zone names must
+// be string literals; only the pointer is stored.
+class Tracer : private juce::Thread
+{
+public:
+    static Tracer& getInstance()
+    {
+        static Tracer instance;
+        return instance;
+    }
+
+    static bool isRecording() noexcept  { return recording.load(std::memory_order_relaxed); }
+
+    // Message thread. Starts a new trace file, replacing any existing one.
+    bool start(const juce::File& file)
+    {
+        stop();
+
+        // Anything left from an earlier trace would have stale timestamps
+        for (auto& buffer : buffers)
+            for (Event event; buffer.events.pop(event);)
+                ;
+
+        file.deleteFile();
+        output = std::make_unique<juce::FileOutputStream>(file);
+
+        if (output->failedToOpen())
+        {
+            output.reset();
+            return false;
+        }
+
+        *output << "{\"traceEvents\":[\n";
+        originTicks = juce::Time::getHighResolutionTicks();
+        numEventsWritten = 0;
+        dropped = 0;
+        recording = true;
+        startThread(juce::Thread::Priority::low);
+        return true;
+    }
+
+    // Message thread. Writes out whatever is still queued and closes the file.
+    void stop()
+    {
+        if (output == nullptr)
+            return;
+
+        recording = false;
+        stopThread(1000);
+        flush();
+
+        // Name each thread's track
+        for (int slot = 0; slot < getNumThreads(); ++slot)
+            if (buffers[(size_t) slot].named.load(std::memory_order_acquire))
+                writeSeparator() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << (slot + 1)
+                                 << ",\"args\":{\"name\":\"" << buffers[(size_t) slot].name << "\"}}";
+
+        *output << "\n],\"otherData\":{\"droppedEvents\":\"" << (int) dropped.load() << "\"}}\n";
+        output.reset();
+    }
+
+    // Any thread, via TRACE_SCOPE
+    void addEvent(const char* name, juce::int64 startTicks, juce::int64 endTicks)
+    {
+        if (auto* buffer = getThreadBuffer())
+            if (!buffer->events.push({ name, startTicks, endTicks }))
+                dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    //==============================================================================
+    class Scope
+    {
+    public:
+        explicit Scope(const char* zoneName) noexcept
+            : name(zoneName), startTicks(juce::Time::getHighResolutionTicks()) {}
+
+        ~Scope()
+        {
+            if (isRecording())
+                getInstance().addEvent(name, startTicks, juce::Time::getHighResolutionTicks());
+        }
+
+    private:
+        const char* const name;
+        const juce::int64 startTicks;
+
+        JUCE_DECLARE_NON_COPYABLE(Scope)
+    };
+
+private:
+    struct Event
+    {
+        const char* name = nullptr;
+        juce::int64 startTicks = 0;
+        juce::int64 endTicks = 0;
+    };
+
+    struct ThreadBuffer
+    {
+        LockFreeFifo<Event, 8192> events;
+        char name[32] = {};
+        std::atomic<bool> named { false };
+    };
+
+    static constexpr int maxThreads = 16;
+
+    Tracer() : juce::Thread("Trace writer") {}
+    ~Tracer() override  { stop(); }
+
+    int getNumThreads() const noexcept  { return juce::jmin(maxThreads, claimedThreads.load()); }
+
+    // Hands each new thread a buffer of its own the first time it records
+    ThreadBuffer* getThreadBuffer()
+    {
+        thread_local int slot = -1;
+
+        if (slot < 0)
+        {
+            const auto claimed = claimedThreads.fetch_add(1);
+
+            if (claimed >= maxThreads)
+            {
+                slot = maxThreads;
+                return nullptr;
+            }
+
+            auto& buffer = buffers[(size_t) claimed];
+            nameThread(buffer.name);
+            buffer.named.store(true, std::memory_order_release);
+            slot = claimed;
+        }
+
+        return slot < maxThreads ? &buffers[(size_t) slot] : nullptr;
+    }
+
+    // Getting a juce::Thread's name allocates, so audio callbacks are named
+    // from the guard instead
+    static void nameThread(char* name)
+    {
+        constexpr auto size = sizeof(ThreadBuffer::name);
+
+        if (AudioThreadGuard::isInCallback())
+            std::strncpy(name, "Audio callback", size - 1);
+        else if (juce::MessageManager::existsAndIsCurrentThread())
+            std::strncpy(name, "Message thread", size - 1);
+        else if (auto* thread = juce::Thread::getCurrentThread())
+            thread->getThreadName().copyToUTF8(name, size);
+        else
+            std::strncpy(name, "Thread", size - 1);
+    }
+
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            wait(100);
+            flush();
+        }
+    }
+
+    // Writer thread, or the message thread once the writer has stopped
+    void flush()
+    {
+        for (int slot = 0; slot < getNumThreads(); ++slot)
+        {
+            for (Event event; buffers[(size_t) slot].events.pop(event);)
+            {
+                const auto startUs = juce::Time::highResolutionTicksToSeconds(event.startTicks - originTicks) * 1.0e6;
+                const auto durationUs = juce::Time::highResolutionTicksToSeconds(event.endTicks - event.startTicks) * 1.0e6;
+
+                if (startUs < 0.0)
+                    continue;
+
+                writeSeparator() << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << (slot + 1)
+                                 << ",\"ts\":" << juce::String(startUs, 3) << ",\"dur\":" << juce::String(durationUs, 3) << "}";
+            }
+        }
+
+        output->flush();
+    }
+
+    juce::OutputStream& writeSeparator()
+    {
+        if (numEventsWritten++ > 0)
+            *output << ",\n";
+
+        return *output;
+    }
+
+    static inline std::atomic<bool> recording { false };
+
+    std::array<ThreadBuffer, maxThreads> buffers;
+    std::atomic<int> claimedThreads { 0 };
+    std::atomic<int> dropped { 0 };     // Events lost to a full buffer
+    std::unique_ptr<juce::FileOutputStream> output;
+    juce::int64 originTicks = 0;
+    int numEventsWritten = 0;
+
+    JUCE_DECLARE_NON_COPYABLE(Tracer)
+};
+
+// Times the rest of the enclosing block as a zone with the given name
+#define TRACE_SCOPE(name) const Tracer::Scope JUCE_JOIN_MACRO(traceScope, __LINE__) (name)
+
+#else
+
+#define TRACE_SCOPE(name)
+
+#endif
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <cmath>
+
+//==============================================================================
+// Where an external clock says playback is at the start of a block
+struct TransportPosition
+{
+    bool isPlaying = false;
+    double ppq = 0.0;               // Quarter notes since the start of the song
+    double bpm = 120.0;
+    double quartersPerBar = 4.0;
+    double barStartPpq = 0.0;       // Start of the bar containing ppq
+    juce::int64 bar = 0;            // Index of that bar
+};
+
+//==============================================================================
+// Follows an external clock (a plugin host's play head or incoming MIDI
+// clock) so chords change on its bar lines. Works in PPQ rather than
+// counting samples, so a tempo change or ramp is picked up at the next block
+// without drifting off the grid. Nothing here allocates.
+class TransportSync
+{
+public:
+    // Reads a plugin host's position, filling in whatever it doesn't report
+    static TransportPosition fromPlayHead(const juce::Optional<juce::AudioPlayHead::PositionInfo>& info) noexcept
+    {
+        TransportPosition position;
+
+        if (!info.hasValue() || !info->getPpqPosition().hasValue())
+            return position;
+
+        const auto signature = info->getTimeSignature().orFallback(juce::AudioPlayHead::TimeSignature());
+        position.isPlaying = info->getIsPlaying();
+        position.ppq = *info->getPpqPosition();
+        position.bpm = info->getBpm().orFallback(120.0);
+        position.quartersPerBar = getQuartersPerBar(signature.numerator, signature.denominator);
+
+        // The host's own bar grid, when reported, allows for earlier time signature changes
+        position.barStartPpq = info->getPpqPositionOfLastBarStart()
+                                   .orFallback(std::floor(position.ppq / position.quartersPerBar) * position.quartersPerBar);
+        position.bar = info->getBarCount().orFallback((juce::int64) std::floor(position.barStartPpq / position.quartersPerBar + 0.5));
+        return position;
+    }
+
+    static double getQuartersPerBar(int beatsPerMeasure, int beatUnit) noexcept
+    {
+        return juce::jmax(1, beatsPerMeasure) * 4.0 / juce::jmax(1, beatUnit);
+    }
+
+    // Calls onBar(bar, sampleOffset) for the bar playing at the start of the
+    // block and again at every bar line that falls inside it
+    template <typename Callback>
+    static void forEachBar(const TransportPosition& position, int numSamples, double sampleRate, Callback&& onBar)
+    {
+        if (!position.isPlaying || sampleRate <= 0.0 || position.bpm <= 0.0)
+            return;
+
+        const auto quartersPerSample = position.bpm / (60.0 * sampleRate);
+        auto bar = position.bar;
+        onBar(bar, 0);
+
+        for (auto nextBar = position.barStartPpq + position.quartersPerBar; ; nextBar += position.quartersPerBar)
+        {
+            const auto offset = (nextBar - position.ppq) / quartersPerSample;
+
+            if (offset >= numSamples)
+                break;
+
+            onBar(++bar, juce::jmax(0, (int) offset));
+        }
+    }
+};
+
+//==============================================================================
+// Turns incoming MIDI clock (24 ticks per quarter note, plus start, stop,
+// continue and song position) into a TransportPosition.
+// The tempo is measured from the tick spacing and smoothed, so jitter from
+// the MIDI driver doesn't wobble it but a tempo ramp is still followed
+// within a few ticks. Between ticks the position is extrapolated, never
+// running more than a tick past the last one received. Audio thread
+// only; times are in seconds on the Time::getMillisecondCounterHiRes() clock.
+class MidiClockFollower
+{
+public:
+    static constexpr int ticksPerQuarter = 24;
+
+    void setTimeSignature(int beatsPerMeasure, int beatUnit) noexcept
+    {
+        quartersPerBar = TransportSync::getQuartersPerBar(beatsPerMeasure, beatUnit);
+    }
+
+    // Returns false if the message isn't a clock message
+    bool handleMessage(const juce::MidiMessage& message, double time) noexcept
+    {
+        if (message.isMidiClock())
+        {
+            if (lastTickTime > 0.0)
+            {
+                const auto interval = time - lastTickTime;
+
+                // Ignore gaps (a paused source) and bursts (a backlog of queued ticks)
+                if (interval > 0.0005 && interval < 0.25)
+                    tickInterval = tickInterval <= 0.0 ? interval : tickInterval + (interval - tickInterval) * smoothing;
+            }
+
+            // The first tick after start or continue marks the current position
+            if (running && !waitingForFirstTick)
+                ++ticks;
+
+            waitingForFirstTick = false;
+            lastTickTime = time;
+            return true;
+        }
+
+        if (message.isMidiStart() || message.isMidiContinue())
+        {
+            if (message.isMidiStart())
+                ticks = 0;
+
+            running = true;
+            waitingForFirstTick = true;
+            return true;
+        }
+
+        if (message.isMidiStop())
+        {
+            running = false;
+            return true;
+        }
+
+        if (message.isSongPositionPointer())
+        {
+            // Song position counts sixteenth notes
+            ticks = (juce::int64) message.getSongPositionPointerMidiBeat() * ticksPerQuarter / 4;
+            return true;
+        }
+
+        return false;
+    }
+
+    bool isRunning() const noexcept  { return running; }
+
+    double getBpm() const noexcept
+    {
+        return tickInterval > 0.0 ? 60.0 / (tickInterval * ticksPerQuarter) : 120.0;
+    }
+
+    TransportPosition getPosition(double time) const noexcept
+    {
+        TransportPosition position;
+        position.isPlaying = running && !waitingForFirstTick;
+        position.bpm = getBpm();
+        position.quartersPerBar = quartersPerBar;
+
+        // Times before the last tick (ticks already queued for a later part of
+        // the block) are extrapolated backwards
+        const auto sinceTick = tickInterval > 0.0 ? juce::jlimit(-(double) ticksPerQuarter, 1.0, (time - lastTickTime) / tickInterval)
+                                                  : 0.0;
+        position.ppq = ((double) ticks + sinceTick) / ticksPerQuarter;
+        position.bar = (juce::int64) std::floor(position.ppq / quartersPerBar);
+        position.barStartPpq = (double) position.bar * quartersPerBar;
+        return position;
+    }
+
+private:
+    static constexpr double smoothing = 0.1;  // Weight given to each new tick interval
+
+    bool running = false;
+    bool waitingForFirstTick = false;
+    juce::int64 ticks = 0;        // Since the start of the song
+    double lastTickTime = 0.0;
+    double tickInterval = 0.0;    // Smoothed seconds per tick
+    double quartersPerBar = 4.0;
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+
+//==============================================================================
+// Hands the latest value of a settings block from one thread to another.
+// Unlike LockFreeFifo, only the newest value matters: the writer can publish
+// as often as it likes and the reader picks up whatever is current. Three
+// slots rotate through a single atomic index, so neither side ever blocks,
+// allocates or sees a half-written value. One writer thread and one reader
+// thread.
+template <typename ValueType>
+class TripleBuffer
+{
+public:
+    TripleBuffer() = default;
+
+    // Writer side
+    void write(const ValueType& value) noexcept
+    {
+        slots[(size_t) writeIndex] = value;
+
+        // Swap the filled slot into the middle, marked as fresh
+        writeIndex = middle.exchange(writeIndex | freshFlag, std::memory_order_acq_rel) & indexMask;
+    }
+
+    // Reader side. Copies the newest value if one has been written since the
+    // last read, and returns whether it did.
+    bool read(ValueType& value) noexcept
+    {
+        if ((middle.load(std::memory_order_acquire) & freshFlag) == 0)
+            return false;
+
+        readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & indexMask;
+        value = slots[(size_t) readIndex];
+        return true;
+    }
+
+private:
+    static constexpr int indexMask = 3;
+    static constexpr int freshFlag = 4;
+
+    std::array<ValueType, 3> slots {};
+    std::atomic<int> middle { 1 };
+    int writeIndex = 0;  // Writer only
+    int readIndex = 2;   // Reader only
+
+    JUCE_DECLARE_NON_COPYABLE(TripleBuffer)
+};
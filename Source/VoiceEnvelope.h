@@ -0,0 +1,188 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <cmath>
+
+//==============================================================================
+// ADSR envelope for synth voices.
+// Times are in seconds, so the shape no longer depends on the device sample
+// rate. Per-sample coefficients are worked out in prepare() and the envelope
+// is applied one segment at a time: the flat sustain stage is a single
+// vector multiply, and only the moving stages are evaluated per sample.
+class VoiceEnvelope
+{
+public:
+    struct Parameters
+    {
+        float attack = 0.005f;   // Short ramp so notes don't click on
+        float decay = 0.1f;
+        float sustain = 1.0f;
+        float release = 0.012f;  // Matches the old tail-off at 44.1 kHz
+    };
+
+    VoiceEnvelope()
+    {
+        prepare(44100.0);
+    }
+
+    void setParameters(const Parameters& newParameters)
+    {
+        parameters = newParameters;
+        prepare(sampleRate);
+    }
+
+    const Parameters& getParameters() const noexcept { return parameters; }
+
+    // Precomputes the per-sample rates; call whenever the sample rate changes
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate > 0.0 ? newSampleRate : 44100.0;
+
+        attackIncrement = parameters.attack > 0.0f ? (float) (1.0 / (parameters.attack * sampleRate)) : 1.0f;
+        decayCoefficient = getCoefficient(parameters.decay, decayThreshold / juce::jmax(decayThreshold * 2.0f, 1.0f - parameters.sustain));
+        releaseCoefficient = getCoefficient(parameters.release, silenceThreshold);
+    }
+
+    void noteOn() noexcept
+    {
+        // Retriggering ramps up from wherever the envelope currently is
+        stage = Stage::Attack;
+    }
+
+    void noteOff() noexcept
+    {
+        if (stage == Stage::Idle)
+            return;
+
+        stage = parameters.release > 0.0f ? Stage::Release : Stage::Idle;
+
+        if (stage == Stage::Idle)
+            level = 0.0f;
+    }
+
+    void reset() noexcept
+    {
+        stage = Stage::Idle;
+        level = 0.0f;
+    }
+
+    bool isActive() const noexcept   { return stage != Stage::Idle; }
+    bool isReleasing() const noexcept { return stage == Stage::Release; }
+
+    // Multiplies the samples by the envelope. Returns how many samples contain
+    // sound: fewer than numSamples means the release finished part way
+    // through, and the voice can be freed straight away.
+    int process(float* samples, int numSamples) noexcept
+    {
+        int position = 0;
+
+        while (position < numSamples)
+        {
+            auto* data = samples + position;
+            const auto remaining = numSamples - position;
+
+            switch (stage)
+            {
+                case Stage::Idle:
+                    return position;
+
+                case Stage::Attack:
+                {
+                    int i = 0;
+
+                    for (; i < remaining && level < 1.0f; ++i)
+                    {
+                        level = juce::jmin(1.0f, level + attackIncrement);
+                        data[i] *= level;
+                    }
+
+                    if (level >= 1.0f)
+                        stage = parameters.sustain < 1.0f ? Stage::Decay : Stage::Sustain;
+
+                    position += i;
+                    break;
+                }
+
+                case Stage::Decay:
+                {
+                    const auto target = parameters.sustain;
+                    int i = 0;
+
+                    for (; i < remaining; ++i)
+                    {
+                        level = target + (level - target) * decayCoefficient;
+                        data[i] *= level;
+
+                        if (level - target <= decayThreshold)
+                        {
+                            level = target;
+                            stage = Stage::Sustain;
+                            ++i;
+                            break;
+                        }
+                    }
+
+                    position += i;
+                    break;
+                }
+
+                case Stage::Sustain:
+                    // Flat: one multiply over the rest of the block
+                    if (level != 1.0f)
+                        juce::FloatVectorOperations::multiply(data, level, remaining);
+
+                    return numSamples;
+
+                case Stage::Release:
+                {
+                    for (int i = 0; i < remaining; ++i)
+                    {
+                        level *= releaseCoefficient;
+                        data[i] *= level;
+
+                        if (level <= silenceThreshold)
+                        {
+                            reset();
+                            return position + i + 1;
+                        }
+                    }
+
+                    return numSamples;
+                }
+            }
+        }
+
+        return numSamples;
+    }
+
+private:
+    enum class Stage
+    {
+        Idle,
+        Attack,
+        Decay,
+        Sustain,
+        Release
+    };
+
+    static constexpr float silenceThreshold = 0.005f;
+    static constexpr float decayThreshold = 0.001f;
+
+    // Per-sample multiplier that shrinks an exponential segment's distance
+    // to its target by the given ratio over the given time
+    float getCoefficient(float seconds, float ratio) const
+    {
+        if (seconds <= 0.0f)
+            return 0.0f;
+
+        return (float) std::exp(std::log(ratio) / (seconds * sampleRate));
+    }
+
+    Parameters parameters;
+    Stage stage = Stage::Idle;
+    double sampleRate = 44100.0;
+    float level = 0.0f;
+    float attackIncrement = 1.0f;
+    float decayCoefficient = 0.0f;
+    float releaseCoefficient = 0.0f;
+};
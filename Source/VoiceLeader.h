@@ -0,0 +1,227 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "PlaybackCommands.h"
+
+//==============================================================================
+// Revoices a whole progression for smooth voice leading.
+// Each chord gets a fixed-size set of candidate voicings (its inversions,
+// moved by whole octaves, that fit inside the register), and a dynamic
+// programme over chord positions picks the assignment with the least total
+// voice movement, so the chords stop jumping around the keyboard. Cost is
+// O(chords x candidates^2); a 64-chord progression takes a few tens of
+// microseconds.
+class VoiceLeader
+{
+public:
+    static constexpr int maxCandidates = 32;
+
+    struct Settings
+    {
+        int lowestNote = 48;   // C3
+        int highestNote = 84;  // C6
+    };
+
+    using Candidates = std::array<ChordNotes, maxCandidates>;
+
+    // Revoices numChords chords in place
+    static void optimise(ChordNotes* chords, int numChords)  { optimise(chords, numChords, Settings()); }
+
+    static void optimise(ChordNotes* chords, int numChords, const Settings& settings)
+    {
+        if (numChords <= 0)
+            return;
+
+        std::vector<Candidates> candidates((size_t) numChords);
+        std::vector<int> numCandidates((size_t) numChords);
+        std::vector<int> cost((size_t) numChords * maxCandidates);
+        std::vector<int> previous((size_t) numChords * maxCandidates);
+
+        for (int i = 0; i < numChords; ++i)
+            numCandidates[(size_t) i] = getCandidates(chords[i], settings, candidates[(size_t) i]);
+
+        // The first chord starts as close to the middle of the register as it can
+        const int centre = (settings.lowestNote + settings.highestNote) / 2;
+
+        for (int c = 0; c < numCandidates[0]; ++c)
+            cost[(size_t) c] = std::abs(getAverageNote(candidates[0][(size_t) c]) - centre);
+
+        for (int i = 1; i < numChords; ++i)
+        {
+            for (int c = 0; c < numCandidates[(size_t) i]; ++c)
+            {
+                int bestCost = std::numeric_limits<int>::max();
+                int bestPrevious = 0;
+
+                for (int p = 0; p < numCandidates[(size_t) i - 1]; ++p)
+                {
+                    auto total = cost[(size_t) ((i - 1) * maxCandidates + p)]
+                               + getSortedMovement(candidates[(size_t) i - 1][(size_t) p], candidates[(size_t) i][(size_t) c]);
+
+                    if (total < bestCost)
+                    {
+                        bestCost = total;
+                        bestPrevious = p;
+                    }
+                }
+
+                cost[(size_t) (i * maxCandidates + c)] = bestCost;
+                previous[(size_t) (i * maxCandidates + c)] = bestPrevious;
+            }
+        }
+
+        // Walk back from the cheapest final voicing
+        const auto last = numChords - 1;
+        const auto* lastCosts = cost.data() + last * maxCandidates;
+        int choice = (int) (std::min_element(lastCosts, lastCosts + numCandidates[(size_t) last]) - lastCosts);
+
+        for (int i = last; i >= 0; --i)
+        {
+            chords[i] = candidates[(size_t) i][(size_t) choice];
+            choice = previous[(size_t) (i * maxCandidates + choice)];
+        }
+    }
+
+    // Returns a revoiced copy; snapshots themselves are immutable
+    static ProgressionSnapshot optimise(const ProgressionSnapshot& progression)
+    {
+        return optimise(progression, Settings());
+    }
+
+    static ProgressionSnapshot optimise(const ProgressionSnapshot& progression, const Settings& settings)
+    {
+        std::array<ChordNotes, ProgressionSnapshot::maxChords> chords;
+
+        for (int i = 0; i < progression.size(); ++i)
+            chords[(size_t) i] = progression[i];
+
+        optimise(chords.data(), progression.size(), settings);
+
+        ProgressionSnapshot result;
+
+        for (int i = 0; i < progression.size(); ++i)
+            result.addChord(chords[(size_t) i]);
+
+        return result;
+    }
+
+    // Fills candidates with the chord's inversions at every octave that fits
+    // the register, each sorted from the bass up. Returns how many were added;
+    // a chord too wide for the register keeps its own voicing.
+    static int getCandidates(const ChordNotes& chord, const Settings& settings, Candidates& candidates)
+    {
+        std::array<int, ChordNotes::maxNotes> notes {};
+        const int numNotes = juce::jlimit(0, ChordNotes::maxNotes, chord.size());
+        int count = 0;
+
+        std::copy(chord.begin(), chord.begin() + numNotes, notes.begin());
+        std::sort(notes.begin(), notes.begin() + numNotes);
+
+        for (int inversion = 0; inversion < numNotes && count < maxCandidates; ++inversion)
+        {
+            if (inversion > 0)
+            {
+                // Next inversion: the bass note moves up an octave
+                notes[0] += 12;
+                std::sort(notes.begin(), notes.begin() + numNotes);
+            }
+
+            const int low = notes[0];
+            const int high = notes[(size_t) numNotes - 1];
+
+            // Every whole-octave shift that keeps the chord inside the register
+            int shift = (int) std::ceil((settings.lowestNote - low) / 12.0) * 12;
+
+            for (; high + shift <= settings.highestNote && count < maxCandidates; shift += 12)
+            {
+                ChordNotes voicing;
+
+                for (int n = 0; n < numNotes; ++n)
+                    voicing.add(notes[(size_t) n] + shift);
+
+                if (voicing.size() == numNotes)
+                    candidates[(size_t) count++] = voicing;
+            }
+        }
+
+        if (count == 0 && numNotes > 0)
+            candidates[(size_t) count++] = sorted(chord);
+
+        return count;
+    }
+
+    // Total semitones the voices move between two chords, in any note order
+    static int getMovement(const ChordNotes& from, const ChordNotes& to)
+    {
+        return getSortedMovement(sorted(from), sorted(to));
+    }
+
+private:
+    static ChordNotes sorted(const ChordNotes& chord)
+    {
+        std::array<int, ChordNotes::maxNotes> notes {};
+        const int numNotes = juce::jlimit(0, ChordNotes::maxNotes, chord.size());
+        std::copy(chord.begin(), chord.begin() + numNotes, notes.begin());
+        std::sort(notes.begin(), notes.begin() + numNotes);
+
+        ChordNotes result;
+
+        for (int n = 0; n < numNotes; ++n)
+            result.add(notes[(size_t) n]);
+
+        return result;
+    }
+
+    // Both chords must be sorted from the bass up. With equal sizes the
+    // voices pair off in order, which is optimal on a line; otherwise each
+    // note is charged the distance to the nearest note of the other chord.
+    static int getSortedMovement(const ChordNotes& from, const ChordNotes& to) noexcept
+    {
+        if (from.size() == to.size())
+        {
+            int total = 0;
+
+            for (int n = 0; n < from.size(); ++n)
+                total += std::abs(from[n] - to[n]);
+
+            return total;
+        }
+
+        return getNearestDistances(from, to) + getNearestDistances(to, from);
+    }
+
+    static int getNearestDistances(const ChordNotes& notes, const ChordNotes& others) noexcept
+    {
+        int total = 0;
+
+        for (int note : notes)
+        {
+            int nearest = 128;
+
+            for (int other : others)
+                nearest = std::min(nearest, std::abs(note - other));
+
+            total += nearest;
+        }
+
+        return total;
+    }
+
+    static int getAverageNote(const ChordNotes& chord) noexcept
+    {
+        if (chord.isEmpty())
+            return 0;
+
+        int sum = 0;
+
+        for (int note : chord)
+            sum += note;
+
+        return sum / chord.size();
+    }
+};